@@ -0,0 +1,44 @@
+// checkscheduler.cpp
+#include "checkscheduler.h"
+
+#include <algorithm>
+
+void CheckScheduler::setBounds(int floorMinutes, int ceilingMinutes)
+{
+    m_floor = std::max(1, floorMinutes);
+    m_ceiling = std::max(m_floor, ceilingMinutes);
+    m_current = std::clamp(m_current, m_floor, m_ceiling);
+}
+
+void CheckScheduler::reset()
+{
+    m_quietStreak = 0;
+    m_current = m_floor;
+}
+
+void CheckScheduler::recordResult(bool foundActivity)
+{
+    if (foundActivity) {
+        m_quietStreak = 0;
+        m_current = m_floor;
+        return;
+    }
+
+    m_quietStreak++;
+    // Double, but stop at the ceiling (and before int overflow)
+    m_current = m_current >= m_ceiling / 2 ? m_ceiling : m_current * 2;
+}
+
+int CheckScheduler::intervalMinutes() const
+{
+    return m_current;
+}
+
+QString CheckScheduler::describe() const
+{
+    return QString("next check in %1 min (floor %2, ceiling %3, %4 quiet checks in a row)")
+        .arg(m_current)
+        .arg(m_floor)
+        .arg(m_ceiling)
+        .arg(m_quietStreak);
+}
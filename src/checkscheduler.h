@@ -0,0 +1,27 @@
+// checkscheduler.h
+#pragma once
+
+#include <QString>
+
+// Picks the delay before the next background check.
+// Checks that find activity pull the interval back to the floor; each
+// quiet check doubles it, up to the ceiling.
+class CheckScheduler
+{
+public:
+    // Minutes. A ceiling below the floor is raised to the floor.
+    void setBounds(int floorMinutes, int ceilingMinutes);
+
+    // Window was hidden: start again from the floor
+    void reset();
+    void recordResult(bool foundActivity);
+
+    int intervalMinutes() const;
+    QString describe() const;
+
+private:
+    int m_floor = 1;
+    int m_ceiling = 30;
+    int m_current = 1;
+    int m_quietStreak = 0;
+};
@@ -5,14 +5,53 @@
 #include <QCoreApplication>
 #include <QDir>
 #include <QFile>
-#include <QSettings>
+#include <QFileSystemWatcher>
 #include <QStandardPaths>
 #include <QTextStream>
 #include <cmath>
 
+namespace {
+
+    // Coalesces bursts such as zoom key presses into one write
+    constexpr int SYNC_DELAY_MS = 2000;
+    // Editors and QSaveFile touch a file several times per save
+    constexpr int RELOAD_DELAY_MS = 500;
+
+    const QString SCHEMA_VERSION_KEY = "Meta/SchemaVersion";
+
+    // ---------------- Migrations ----------------
+
+    // Each step upgrades a file written for the previous version.
+    // Append only: a shipped migration must keep its number.
+    struct Migration {
+        int version;
+        const char *description;
+        void (*apply)(IniStore &store);
+    };
+
+    void moveMinimizeToTray(IniStore &store) {
+        if (store.contains("System/MinimizeToTray") &&
+            !store.contains("Window/MinimizeToTray")) {
+            bool val = store.value("System/MinimizeToTray", true).toBool();
+            store.remove("System/MinimizeToTray");
+            store.setValue("Window/MinimizeToTray", val);
+        }
+    }
+
+    constexpr Migration MIGRATIONS[] = {
+        { 1, "MinimizeToTray moved from System to Window", moveMinimizeToTray },
+    };
+
+    constexpr int SCHEMA_VERSION = 1;
+    static_assert(SCHEMA_VERSION == MIGRATIONS[std::size(MIGRATIONS) - 1].version,
+                  "SCHEMA_VERSION must be the last migration's version");
+
+}
+
 // ---------------- Constructor ----------------
 
-ConfigManager::ConfigManager() {
+ConfigManager::ConfigManager(QObject *parent)
+: QObject(parent) {
     m_configDir =
         QStandardPaths::writableLocation(QStandardPaths::ConfigLocation) +
         "/whatsit";
@@ -20,179 +59,357 @@ ConfigManager::ConfigManager() {
     QDir().mkpath(m_configDir);
 
     m_configPath = m_configDir + "/whatsit.ini";
+
+    m_store.read(m_configPath);
+    m_customStore.read(m_configDir + "/custom.ini");
+    // Before anything reads a value; load() writes the result
+    runMigrations();
+    readValues();
+    readCustomValues();
+
+    m_syncTimer.setSingleShot(true);
+    m_syncTimer.setInterval(SYNC_DELAY_MS);
+    connect(&m_syncTimer, &QTimer::timeout, this, &ConfigManager::sync);
+
+    m_reloadTimer.setSingleShot(true);
+    m_reloadTimer.setInterval(RELOAD_DELAY_MS);
+    connect(&m_reloadTimer, &QTimer::timeout, this, &ConfigManager::reload);
+}
+
+ConfigManager::~ConfigManager() {
+    sync();
 }
 
 // ---------------- Lifecycle ----------------
 
 void ConfigManager::load() {
     Logger::log("Loading configuration...");
-    // --- Boolean schema ---
-    loadBool("General/RememberDownloadPaths", true);
-    loadBool("General/ShowTrayTooltip", true);
-
-    loadBool("Window/MaximizedByDefault", false);
-    loadBool("Window/RememberWindowSize", true);
-
-    // Migration: MinimizeToTray moved from System to Window
-    QSettings settings(m_configPath, QSettings::IniFormat);
-    if (settings.contains("System/MinimizeToTray") &&
-        !settings.contains("Window/MinimizeToTray")) {
-        bool val = settings.value("System/MinimizeToTray", true).toBool();
-        settings.remove("System/MinimizeToTray");
-        settings.setValue("Window/MinimizeToTray", val);
+
+    // Every boolean option is written out, so the file documents them
+    for (const ConfigSchema::BoolDef &entry : ConfigSchema::BOOL_KEYS) {
+        if (!m_store.contains(entry.path))
+            m_store.setValue(entry.path, entry.defaultValue);
+    }
+
+    // Ensure autostart state is reflected on disk
+    applyAutostart(get(BoolKey::AutostartOnLogin));
+
+    // Only a first run or a migration has anything to write here
+    sync();
+
+    if (!m_watcher) {
+        m_watcher = new QFileSystemWatcher(this);
+        connect(m_watcher, &QFileSystemWatcher::fileChanged, &m_reloadTimer, qOverload<>(&QTimer::start));
+        connect(m_watcher, &QFileSystemWatcher::directoryChanged, &m_reloadTimer, qOverload<>(&QTimer::start));
     }
-    loadBool("Window/MinimizeToTray", true);
+    watchFiles();
+}
+
+void ConfigManager::sync() {
+    m_syncTimer.stop();
+    if (!m_store.isDirty() && !m_customStore.isDirty())
+        return;
+
+    Logger::log("Syncing configuration to disk: " + m_configPath);
+    m_store.write();
+    m_customStore.write();
+}
 
-    loadBool("System/AutostartOnLogin", false);
-    loadBool("System/StartMinimizedInTray", false);
-    loadBool("System/ShowTrayIndicator", true);
-    loadBool("System/SystemNotifications", true);
-    loadBool("System/MuteAudio", false);
+void ConfigManager::readValues() {
+    for (const ConfigSchema::BoolDef &entry : ConfigSchema::BOOL_KEYS)
+        m_bools[std::size_t(entry.key)] = m_store.value(entry.path, entry.defaultValue).toBool();
 
-    loadBool("Advanced/UseLessMemory", false);
+    for (const ConfigSchema::IntDef &entry : ConfigSchema::INT_KEYS) {
+        bool ok = false;
+        const int value = m_store.value(entry.path).toInt(&ok);
+        m_ints[std::size_t(entry.key)] = ok && value >= entry.minimum ? value : entry.defaultValue;
+    }
 
-    QSettings settings_adv(m_configPath, QSettings::IniFormat);
-    int memLimit = settings_adv.value("Advanced/MemoryLimit", 0).toInt();
-    m_memoryLimit = memLimit;
+    for (const ConfigSchema::DoubleDef &entry : ConfigSchema::DOUBLE_KEYS) {
+        bool ok = false;
+        const double value = m_store.value(entry.path).toDouble(&ok);
+        m_doubles[std::size_t(entry.key)] = ok ? value : entry.defaultValue;
+    }
 
-    m_backgroundCheckInterval = settings_adv.value("Advanced/BackgroundCheckInterval", 0).toInt();
+    for (const ConfigSchema::StringDef &entry : ConfigSchema::STRING_KEYS)
+        m_strings[std::size_t(entry.key)] = m_store.value(entry.path, QString::fromUtf8(entry.defaultValue)).toString();
 
-    loadBool("Debug/EnableFileLogging", false);
+    for (const ConfigSchema::StringListDef &entry : ConfigSchema::STRING_LIST_KEYS) {
+        QStringList defaultValue;
+        for (const char *const *item = entry.defaultValue; item && *item; ++item)
+            defaultValue << QString::fromUtf8(*item);
+        m_stringLists[std::size_t(entry.key)] = m_store.value(entry.path, defaultValue).toStringList();
+    }
 
-    // Ensure autostart state is reflected on disk
-    applyAutostart(boolValue("System/AutostartOnLogin"));
+    for (const ConfigSchema::SizeDef &entry : ConfigSchema::SIZE_KEYS) {
+        const QSize value = m_store.value(entry.path).toSize();
+        m_sizes[std::size_t(entry.key)] = value.isValid() ? value : QSize(entry.defaultWidth, entry.defaultHeight);
+    }
+}
 
-    sync();
+void ConfigManager::readCustomValues() {
+    for (const ConfigSchema::CustomDef &entry : ConfigSchema::CUSTOM_KEYS)
+        m_customs[std::size_t(entry.key)] = m_customStore.value(entry.path).toString();
 }
 
-void ConfigManager::sync() {
-    Logger::log("Syncing configuration to disk: " + m_configPath);
-    QSettings settings(m_configPath, QSettings::IniFormat);
+void ConfigManager::reload() {
+    watchFiles();
 
-    for (auto it = m_boolValues.constBegin(); it != m_boolValues.constEnd();
-         ++it) {
-        settings.setValue(it.key(), it.value());
+    // Our own writes leave the stamps matching and end here
+    const bool storeChanged = m_store.refresh();
+    const bool customStoreChanged = m_customStore.refresh();
+    if (!storeChanged && !customStoreChanged)
+        return;
+    Logger::log("Configuration changed on disk, reloading");
+
+    if (storeChanged) {
+        const auto bools = m_bools;
+        const auto ints = m_ints;
+        const auto doubles = m_doubles;
+        const auto strings = m_strings;
+        const auto stringLists = m_stringLists;
+        readValues();
+
+        for (const ConfigSchema::BoolDef &entry : ConfigSchema::BOOL_KEYS) {
+            if (get(entry.key) != bools[std::size_t(entry.key)])
+                emit boolChanged(entry.key, get(entry.key));
+        }
+        for (const ConfigSchema::IntDef &entry : ConfigSchema::INT_KEYS) {
+            if (get(entry.key) != ints[std::size_t(entry.key)])
+                emit intChanged(entry.key, get(entry.key));
+        }
+        for (const ConfigSchema::DoubleDef &entry : ConfigSchema::DOUBLE_KEYS) {
+            if (get(entry.key) != doubles[std::size_t(entry.key)])
+                emit doubleChanged(entry.key, get(entry.key));
+        }
+        for (const ConfigSchema::StringDef &entry : ConfigSchema::STRING_KEYS) {
+            if (get(entry.key) != strings[std::size_t(entry.key)])
+                emit stringChanged(entry.key, get(entry.key));
+        }
+        for (const ConfigSchema::StringListDef &entry : ConfigSchema::STRING_LIST_KEYS) {
+            if (get(entry.key) != stringLists[std::size_t(entry.key)])
+                emit stringListChanged(entry.key, get(entry.key));
+        }
+        // Window/Size is only ever written by the window itself
+    }
+
+    if (customStoreChanged) {
+        const auto customs = m_customs;
+        readCustomValues();
+        for (const ConfigSchema::CustomDef &entry : ConfigSchema::CUSTOM_KEYS) {
+            if (get(entry.key) != customs[std::size_t(entry.key)])
+                emit customChanged(entry.key, get(entry.key));
+        }
     }
+}
+
+void ConfigManager::watchFiles() {
+    if (m_watcher->directories().isEmpty())
+        m_watcher->addPath(m_configDir); // sees custom.ini being created
+
+    const QStringList watched = m_watcher->files();
+    for (const QString &path : { m_store.path(), m_customStore.path() }) {
+        if (!watched.contains(path) && QFile::exists(path))
+            m_watcher->addPath(path);
+    }
+}
 
-    settings.sync();
+void ConfigManager::runMigrations() {
+    const int version = m_store.value(SCHEMA_VERSION_KEY, 0).toInt();
+    if (version > SCHEMA_VERSION) {
+        Logger::log(Logger::Level::Warning, QString("Config schema version %1 is newer than this build (%2); not migrating")
+                .arg(version).arg(SCHEMA_VERSION));
+        return;
+    }
+    if (version == SCHEMA_VERSION)
+        return;
+
+    for (const Migration &migration : MIGRATIONS) {
+        if (migration.version <= version)
+            continue;
+        Logger::log(QString("Config migration %1: %2").arg(migration.version).arg(migration.description));
+        migration.apply(m_store);
+    }
+    m_store.setValue(SCHEMA_VERSION_KEY, SCHEMA_VERSION);
 }
 
 // ---------------- Getters ----------------
 
 bool ConfigManager::rememberDownloadPaths() const {
-    return boolValue("General/RememberDownloadPaths");
+    return get(BoolKey::RememberDownloadPaths);
 }
 
 bool ConfigManager::showTrayTooltip() const {
-    return boolValue("General/ShowTrayTooltip");
+    return get(BoolKey::ShowTrayTooltip);
 }
 
 bool ConfigManager::maximizedByDefault() const {
-    return boolValue("Window/MaximizedByDefault");
+    return get(BoolKey::MaximizedByDefault);
 }
 
 bool ConfigManager::rememberWindowSize() const {
-    return boolValue("Window/RememberWindowSize");
+    return get(BoolKey::RememberWindowSize);
 }
 
-QSize ConfigManager::windowSize() const {
-    return QSettings(m_configPath, QSettings::IniFormat)
-        .value("Window/Size", QSize(900, 600))
-        .toSize();
-}
+QSize ConfigManager::windowSize() const { return get(SizeKey::WindowSize); }
 
 double ConfigManager::zoomLevel() const {
-    return QSettings(m_configPath, QSettings::IniFormat)
-        .value("Window/ZoomLevel", 1.0)
-        .toDouble();
+    return get(DoubleKey::ZoomLevel);
 }
 
 bool ConfigManager::autostartOnLogin() const {
-    return boolValue("System/AutostartOnLogin");
+    return get(BoolKey::AutostartOnLogin);
 }
 
 bool ConfigManager::minimizeToTray() const {
-    return boolValue("Window/MinimizeToTray");
+    return get(BoolKey::MinimizeToTray);
 }
 
 bool ConfigManager::startMinimizedInTray() const {
-    return boolValue("System/StartMinimizedInTray");
+    return get(BoolKey::StartMinimizedInTray);
 }
 
 bool ConfigManager::showTrayIndicator() const {
-    return boolValue("System/ShowTrayIndicator");
+    return get(BoolKey::ShowTrayIndicator);
 }
 
 bool ConfigManager::systemNotifications() const {
-    return boolValue("System/SystemNotifications");
+    return get(BoolKey::SystemNotifications);
 }
 
-bool ConfigManager::muteAudio() const { return boolValue("System/MuteAudio"); }
+bool ConfigManager::muteAudio() const { return get(BoolKey::MuteAudio); }
 
 bool ConfigManager::useLessMemory() const {
-    return boolValue("Advanced/UseLessMemory");
+    return get(BoolKey::UseLessMemory);
+}
+
+bool ConfigManager::reactToSystemPressure() const {
+    return get(BoolKey::ReactToSystemPressure);
 }
 
-int ConfigManager::memoryLimit() const { return m_memoryLimit; }
+int ConfigManager::memoryLimit() const { return get(IntKey::MemoryLimit); }
+
+// Space separated, as MemoryLadder::setSteps() takes it
+QString ConfigManager::memoryLadder() const {
+    return get(StringListKey::MemoryLadder).join(' ');
+}
+
+int ConfigManager::memoryLadderHysteresis() const {
+    return get(IntKey::MemoryLadderHysteresis);
+}
 
 int ConfigManager::backgroundCheckInterval() const {
-    return m_backgroundCheckInterval;
+    return get(IntKey::BackgroundCheckInterval);
 }
 
-bool ConfigManager::debugLoggingEnabled() const {
-    return boolValue("Debug/EnableFileLogging");
+int ConfigManager::backgroundCheckTimeout() const {
+    return get(IntKey::BackgroundCheckTimeout);
 }
 
-QString ConfigManager::downloadPath() const {
-    return QSettings(m_configPath, QSettings::IniFormat)
-        .value("Downloads/DownloadPath", QStandardPaths::writableLocation(
-                                             QStandardPaths::DownloadLocation))
-        .toString();
+int ConfigManager::backgroundCheckMaxInterval() const {
+    return get(IntKey::BackgroundCheckMaxInterval);
 }
 
-QString ConfigManager::customUrl() const {
-    QString customPath = m_configDir + "/custom.ini";
-    return QSettings(customPath, QSettings::IniFormat)
-        .value("Custom/Url", "")
-        .toString();
+int ConfigManager::freezeDelay() const { return get(IntKey::FreezeDelay); }
+
+int ConfigManager::discardDelay() const { return get(IntKey::DiscardDelay); }
+
+bool ConfigManager::deepSleep() const {
+    return get(BoolKey::DeepSleep);
 }
 
-void ConfigManager::setCustomUrl(const QString &url) {
-    QString customPath = m_configDir + "/custom.ini";
-    QSettings settings(customPath, QSettings::IniFormat);
-    settings.setValue("Custom/Url", url);
-    settings.sync();
+int ConfigManager::deepSleepDelay() const { return get(IntKey::DeepSleepDelay); }
+
+bool ConfigManager::splitProcess() const {
+    return get(BoolKey::SplitProcess);
 }
 
-QString ConfigManager::customTrayIcon() const {
-    QString customPath = m_configDir + "/custom.ini";
-    return QSettings(customPath, QSettings::IniFormat)
-        .value("Custom/TrayIcon", "")
-        .toString();
+int ConfigManager::stubIdleExit() const { return get(IntKey::StubIdleExit); }
+
+bool ConfigManager::showSnapshot() const {
+    return get(BoolKey::ShowSnapshot);
 }
 
-QString ConfigManager::customAppIcon() const {
-    QString customPath = m_configDir + "/custom.ini";
-    return QSettings(customPath, QSettings::IniFormat)
-        .value("Custom/AppIcon", "")
-        .toString();
+bool ConfigManager::snapshotOnDisk() const {
+    return get(BoolKey::SnapshotOnDisk);
+}
+
+int ConfigManager::snapshotMaxSize() const { return get(IntKey::SnapshotMaxSize); }
+
+bool ConfigManager::prewarmOnIntent() const {
+    return get(BoolKey::PrewarmOnIntent);
+}
+
+int ConfigManager::prewarmTimeout() const { return get(IntKey::PrewarmTimeout); }
+
+bool ConfigManager::predictivePreload() const {
+    return get(BoolKey::PredictivePreload);
+}
+
+int ConfigManager::predictiveLead() const { return get(IntKey::PredictiveLead); }
+
+int ConfigManager::predictiveWindow() const { return get(IntKey::PredictiveWindow); }
+
+QString ConfigManager::httpCacheType() const { return get(StringKey::HttpCacheType); }
+
+int ConfigManager::httpCacheMaximumSize() const {
+    return get(IntKey::HttpCacheMaximumSize);
+}
+
+QString ConfigManager::engineProfile() const {
+    return get(StringKey::EngineProfile);
+}
+
+QString ConfigManager::customChromiumFlags() const {
+    return get(StringKey::CustomChromiumFlags);
+}
+
+bool ConfigManager::debugLoggingEnabled() const {
+    return get(BoolKey::EnableFileLogging);
+}
+
+bool ConfigManager::tracingEnabled() const {
+    return get(BoolKey::EnableTracing);
+}
+
+int ConfigManager::logMaxSizeKb() const { return get(IntKey::LogMaxSizeKb); }
+
+int ConfigManager::logMaxFiles() const { return get(IntKey::LogMaxFiles); }
+
+QString ConfigManager::logLevel() const { return get(StringKey::LogLevel); }
+
+QString ConfigManager::logCategories() const { return get(StringKey::LogCategories); }
+
+QStringList ConfigManager::consoleFilters() const {
+    return get(StringListKey::ConsoleFilters);
+}
+
+QString ConfigManager::downloadPath() const {
+    const QString &path = get(StringKey::DownloadPath);
+    return path.isEmpty() ? QStandardPaths::writableLocation(QStandardPaths::DownloadLocation) : path;
+}
+
+QString ConfigManager::customUrl() const { return get(CustomKey::Url); }
+
+void ConfigManager::setCustomUrl(const QString &url) {
+    set(CustomKey::Url, url);
 }
 
+QString ConfigManager::customTrayIcon() const { return get(CustomKey::TrayIcon); }
+
+QString ConfigManager::customAppIcon() const { return get(CustomKey::AppIcon); }
+
 void ConfigManager::setCustomTrayIcon(const QString &icon) {
-    QString customPath = m_configDir + "/custom.ini";
-    QSettings settings(customPath, QSettings::IniFormat);
-    settings.setValue("Custom/TrayIcon", icon);
-    settings.sync();
+    set(CustomKey::TrayIcon, icon);
 }
 void ConfigManager::setCustomAppIcon(const QString &icon) {
-    QString customPath = m_configDir + "/custom.ini";
-    QSettings settings(customPath, QSettings::IniFormat);
-    settings.setValue("Custom/AppIcon", icon);
-    settings.sync();
+    set(CustomKey::AppIcon, icon);
 }
 
 void ConfigManager::removeCustomConfig() {
     QString customPath = m_configDir + "/custom.ini";
+    m_customStore.clear();
+    readCustomValues();
     if (QFile::exists(customPath)) {
         QFile::remove(customPath);
     }
@@ -201,79 +418,150 @@ void ConfigManager::removeCustomConfig() {
 // ---------------- Setters ----------------
 
 void ConfigManager::setRememberDownloadPaths(bool v) {
-    setBoolValue("General/RememberDownloadPaths", v);
+    set(BoolKey::RememberDownloadPaths, v);
 }
 
 void ConfigManager::setShowTrayTooltip(bool v) {
-    setBoolValue("General/ShowTrayTooltip", v);
+    set(BoolKey::ShowTrayTooltip, v);
 }
 
 void ConfigManager::setMaximizedByDefault(bool v) {
-    setBoolValue("Window/MaximizedByDefault", v);
+    set(BoolKey::MaximizedByDefault, v);
 }
 
 void ConfigManager::setRememberWindowSize(bool v) {
-    setBoolValue("Window/RememberWindowSize", v);
+    set(BoolKey::RememberWindowSize, v);
 }
 
 void ConfigManager::setWindowSize(const QSize &size) {
-    QSettings(m_configPath, QSettings::IniFormat).setValue("Window/Size", size);
+    set(SizeKey::WindowSize, size);
 }
 
 void ConfigManager::setZoomLevel(double level) {
     // Ensure we store a clean 1-decimal value
     double rounded = std::round(level * 10.0) / 10.0;
-    QSettings(m_configPath, QSettings::IniFormat).setValue("Window/ZoomLevel", rounded);
+    set(DoubleKey::ZoomLevel, rounded);
 }
 
 void ConfigManager::setAutostartOnLogin(bool v) {
-    setBoolValue("System/AutostartOnLogin", v);
+    set(BoolKey::AutostartOnLogin, v);
     applyAutostart(v);
 }
 
 void ConfigManager::setMinimizeToTray(bool v) {
-    setBoolValue("Window/MinimizeToTray", v);
+    set(BoolKey::MinimizeToTray, v);
 }
 
 void ConfigManager::setStartMinimizedInTray(bool v) {
-    setBoolValue("System/StartMinimizedInTray", v);
+    set(BoolKey::StartMinimizedInTray, v);
 }
 
 void ConfigManager::setShowTrayIndicator(bool v) {
-    setBoolValue("System/ShowTrayIndicator", v);
+    set(BoolKey::ShowTrayIndicator, v);
 }
 
 void ConfigManager::setSystemNotifications(bool v) {
-    setBoolValue("System/SystemNotifications", v);
+    set(BoolKey::SystemNotifications, v);
 }
 
 void ConfigManager::setMuteAudio(bool v) {
-    setBoolValue("System/MuteAudio", v);
+    set(BoolKey::MuteAudio, v);
 }
 
 void ConfigManager::setUseLessMemory(bool v) {
-    setBoolValue("Advanced/UseLessMemory", v);
+    set(BoolKey::UseLessMemory, v);
+}
+
+void ConfigManager::setReactToSystemPressure(bool v) {
+    set(BoolKey::ReactToSystemPressure, v);
 }
 
 void ConfigManager::setMemoryLimit(int limit) {
-    m_memoryLimit = limit;
-    QSettings(m_configPath, QSettings::IniFormat)
-        .setValue("Advanced/MemoryLimit", limit);
+    set(IntKey::MemoryLimit, limit);
+}
+
+void ConfigManager::setMemoryLadder(const QString &spec) {
+    set(StringListKey::MemoryLadder, spec.split(' ', Qt::SkipEmptyParts));
 }
 
 void ConfigManager::setBackgroundCheckInterval(int interval) {
-    m_backgroundCheckInterval = interval;
-    QSettings(m_configPath, QSettings::IniFormat)
-        .setValue("Advanced/BackgroundCheckInterval", interval);
+    set(IntKey::BackgroundCheckInterval, interval);
+}
+
+void ConfigManager::setBackgroundCheckTimeout(int seconds) {
+    set(IntKey::BackgroundCheckTimeout, seconds);
+}
+
+void ConfigManager::setBackgroundCheckMaxInterval(int minutes) {
+    set(IntKey::BackgroundCheckMaxInterval, minutes);
+}
+
+void ConfigManager::setFreezeDelay(int seconds) {
+    set(IntKey::FreezeDelay, seconds);
+}
+
+void ConfigManager::setDiscardDelay(int minutes) {
+    set(IntKey::DiscardDelay, minutes);
+}
+
+void ConfigManager::setDeepSleep(bool v) {
+    set(BoolKey::DeepSleep, v);
+}
+
+void ConfigManager::setDeepSleepDelay(int minutes) {
+    set(IntKey::DeepSleepDelay, minutes);
+}
+
+void ConfigManager::setSplitProcess(bool v) {
+    set(BoolKey::SplitProcess, v);
+}
+
+void ConfigManager::setStubIdleExit(int minutes) {
+    set(IntKey::StubIdleExit, minutes);
+}
+
+void ConfigManager::setShowSnapshot(bool v) {
+    set(BoolKey::ShowSnapshot, v);
+}
+
+void ConfigManager::setSnapshotOnDisk(bool v) {
+    set(BoolKey::SnapshotOnDisk, v);
+}
+
+void ConfigManager::setPrewarmOnIntent(bool v) {
+    set(BoolKey::PrewarmOnIntent, v);
+}
+
+void ConfigManager::setPredictivePreload(bool v) {
+    set(BoolKey::PredictivePreload, v);
+}
+
+void ConfigManager::setHttpCacheType(const QString &type) {
+    set(StringKey::HttpCacheType, type);
+}
+
+void ConfigManager::setHttpCacheMaximumSize(int megabytes) {
+    set(IntKey::HttpCacheMaximumSize, megabytes);
+}
+
+void ConfigManager::setEngineProfile(const QString &profile) {
+    set(StringKey::EngineProfile, profile);
+}
+
+void ConfigManager::setCustomChromiumFlags(const QString &flags) {
+    set(StringKey::CustomChromiumFlags, flags);
 }
 
 void ConfigManager::setDebugLoggingEnabled(bool v) {
-    setBoolValue("Debug/EnableFileLogging", v);
+    set(BoolKey::EnableFileLogging, v);
+}
+
+void ConfigManager::setTracingEnabled(bool v) {
+    set(BoolKey::EnableTracing, v);
 }
 
 void ConfigManager::setDownloadPath(const QString &path) {
-    QSettings(m_configPath, QSettings::IniFormat)
-        .setValue("Downloads/DownloadPath", path);
+    set(StringKey::DownloadPath, path);
 }
 
 // ---------------- Paths ----------------
@@ -282,23 +570,49 @@ QString ConfigManager::configDir() const { return m_configDir; }
 
 // ---------------- Internal helpers ----------------
 
-void ConfigManager::loadBool(const QString &key, bool defaultValue) {
-    QSettings settings(m_configPath, QSettings::IniFormat);
+void ConfigManager::set(BoolKey key, bool value) {
+    m_bools[std::size_t(key)] = value;
+    setValue(ConfigSchema::def(key).path, value);
+}
+
+void ConfigManager::set(IntKey key, int value) {
+    m_ints[std::size_t(key)] = value;
+    setValue(ConfigSchema::def(key).path, value);
+}
+
+void ConfigManager::set(DoubleKey key, double value) {
+    m_doubles[std::size_t(key)] = value;
+    setValue(ConfigSchema::def(key).path, value);
+}
 
-    bool value = settings.value(key, defaultValue).toBool();
-    m_boolValues.insert(key, value);
-    settings.setValue(key, value);
+void ConfigManager::set(StringKey key, const QString &value) {
+    m_strings[std::size_t(key)] = value;
+    setValue(ConfigSchema::def(key).path, value);
 }
 
-bool ConfigManager::boolValue(const QString &key) const {
-    return m_boolValues.value(key, false);
+void ConfigManager::set(StringListKey key, const QStringList &value) {
+    m_stringLists[std::size_t(key)] = value;
+    setValue(ConfigSchema::def(key).path, value);
 }
 
-void ConfigManager::setBoolValue(const QString &key, bool value) {
-    m_boolValues[key] = value;
+void ConfigManager::set(SizeKey key, const QSize &value) {
+    m_sizes[std::size_t(key)] = value;
+    setValue(ConfigSchema::def(key).path, value);
+}
+
+void ConfigManager::set(CustomKey key, const QString &value) {
+    m_customs[std::size_t(key)] = value;
+    setCustomValue(ConfigSchema::def(key).path, value);
+}
+
+void ConfigManager::setValue(const QString &key, const QVariant &value) {
+    if (m_store.setValue(key, value))
+        m_syncTimer.start();
+}
 
-    QSettings settings(m_configPath, QSettings::IniFormat);
-    settings.setValue(key, value);
+void ConfigManager::setCustomValue(const QString &key, const QVariant &value) {
+    if (m_customStore.setValue(key, value))
+        m_syncTimer.start();
 }
 
 // ---------------- Autostart ----------------
@@ -1,15 +1,35 @@
 // configmanager.h
 #pragma once
 
-#include <QMap>
+#include "configschema.h"
+#include "inistore.h"
+
+#include <QObject>
 #include <QSize>
 #include <QString>
-
-class ConfigManager {
+#include <QStringList>
+#include <QTimer>
+#include <array>
+
+class QFileSystemWatcher;
+
+// Settings live in memory; the constructor reads whatsit.ini and
+// custom.ini once and upgrades an old whatsit.ini, so every getter is
+// valid from then on, before QApplication exists. Setters only mark keys dirty, and the changes are
+// written together shortly after the last one, by sync(), and on
+// destruction. After load(), edits made to the files by anyone else (the
+// other split-process half, an editor, a pushed config) are read back and
+// announced by the *Changed signals.
+class ConfigManager : public QObject {
+    Q_OBJECT
   public:
-    ConfigManager();
+    explicit ConfigManager(QObject *parent = nullptr);
+    ~ConfigManager() override;
 
+    // Writes out defaults and starts watching the files: call once
+    // QApplication exists
     void load();
+    // Write pending changes now
     void sync();
 
     // --- General ---
@@ -32,11 +52,48 @@ class ConfigManager {
 
     // --- Advanced ---
     bool useLessMemory() const;
+    bool reactToSystemPressure() const;
     int memoryLimit() const;
+    QString memoryLadder() const;
+    int memoryLadderHysteresis() const;
     int backgroundCheckInterval() const;
+    int backgroundCheckTimeout() const; // seconds, ceiling for one check
+    int backgroundCheckMaxInterval() const; // minutes, back-off ceiling
+    int freezeDelay() const;
+    int discardDelay() const;
+    bool deepSleep() const;
+    int deepSleepDelay() const; // minutes hidden before the web view is destroyed
+    // Tray stub owns the tray; the WebEngine UI process runs only on demand
+    bool splitProcess() const;
+    int stubIdleExit() const;   // minutes hidden before the UI process exits
+    // Last-frame snapshot shown while an unloaded page comes back
+    bool showSnapshot() const;
+    bool snapshotOnDisk() const;
+    int snapshotMaxSize() const; // KB
+    // Start loading a hidden page when the tray suggests a show is coming
+    bool prewarmOnIntent() const;
+    int prewarmTimeout() const;  // seconds before an unused prewarm is dropped
+    // Load the page shortly before the times the window is usually opened
+    bool predictivePreload() const;
+    int predictiveLead() const;   // minutes before a typical open
+    int predictiveWindow() const; // minutes to keep it loaded waiting for the show
+
+    // --- Cache ---
+    QString httpCacheType() const;     // "disk", "memory" or "none"
+    int httpCacheMaximumSize() const;  // MB, 0 = Chromium default
+
+    // --- Engine ---
+    QString engineProfile() const;
+    QString customChromiumFlags() const;
 
     // Debug
     bool debugLoggingEnabled() const;
+    bool tracingEnabled() const;
+    int logMaxSizeKb() const; // whatsit.log is rotated at this size
+    int logMaxFiles() const;  // including the current one
+    QString logLevel() const;      // empty: debug with file logging on, else info
+    QString logCategories() const; // see Logger::parseCategories
+    QStringList consoleFilters() const; // regexes; matching JS console lines are not logged
 
     // --- Downloads ---
     QString downloadPath() const;
@@ -71,29 +128,100 @@ class ConfigManager {
 
     // --- Advanced ---
     void setUseLessMemory(bool);
+    void setReactToSystemPressure(bool);
     void setMemoryLimit(int);
+    void setMemoryLadder(const QString &);
     void setBackgroundCheckInterval(int);
+    void setBackgroundCheckTimeout(int);
+    void setBackgroundCheckMaxInterval(int);
+    void setFreezeDelay(int);
+    void setDiscardDelay(int);
+    void setDeepSleep(bool);
+    void setDeepSleepDelay(int);
+    void setSplitProcess(bool);
+    void setStubIdleExit(int);
+    void setShowSnapshot(bool);
+    void setSnapshotOnDisk(bool);
+    void setPrewarmOnIntent(bool);
+    void setPredictivePreload(bool);
+
+    void setHttpCacheType(const QString &);
+    void setHttpCacheMaximumSize(int);
+
+    void setEngineProfile(const QString &);
+    void setCustomChromiumFlags(const QString &);
 
     // Debug
     void setDebugLoggingEnabled(bool);
+    void setTracingEnabled(bool);
 
     void setDownloadPath(const QString &);
 
     QString configDir() const;
 
+  signals:
+    // Values changed on disk, not by our own setters
+    void boolChanged(ConfigSchema::BoolKey key, bool value);
+    void intChanged(ConfigSchema::IntKey key, int value);
+    void doubleChanged(ConfigSchema::DoubleKey key, double value);
+    void stringChanged(ConfigSchema::StringKey key, const QString &value);
+    void stringListChanged(ConfigSchema::StringListKey key, const QStringList &value);
+    void customChanged(ConfigSchema::CustomKey key, const QString &value);
+
   private:
+    using BoolKey = ConfigSchema::BoolKey;
+    using IntKey = ConfigSchema::IntKey;
+    using DoubleKey = ConfigSchema::DoubleKey;
+    using StringKey = ConfigSchema::StringKey;
+    using StringListKey = ConfigSchema::StringListKey;
+    using SizeKey = ConfigSchema::SizeKey;
+    using CustomKey = ConfigSchema::CustomKey;
+
     QString m_configDir;
     QString m_configPath;
 
-    int m_memoryLimit = 0;
-    int m_backgroundCheckInterval = 0;
-
-    // Centralized boolean storage
-    QMap<QString, bool> m_boolValues;
-
-    void loadBool(const QString &key, bool defaultValue);
-    bool boolValue(const QString &key) const;
-    void setBoolValue(const QString &key, bool value);
+    IniStore m_store;       // whatsit.ini
+    IniStore m_customStore; // custom.ini
+    QTimer m_syncTimer;
+    QFileSystemWatcher *m_watcher = nullptr; // created by load(): needs QApplication
+    QTimer m_reloadTimer;
+
+    // Indexed by the ConfigSchema enums
+    std::array<bool, std::size_t(BoolKey::Count)> m_bools {};
+    std::array<int, std::size_t(IntKey::Count)> m_ints {};
+    std::array<double, std::size_t(DoubleKey::Count)> m_doubles {};
+    std::array<QString, std::size_t(StringKey::Count)> m_strings;
+    std::array<QStringList, std::size_t(StringListKey::Count)> m_stringLists;
+    std::array<QSize, std::size_t(SizeKey::Count)> m_sizes;
+    std::array<QString, std::size_t(CustomKey::Count)> m_customs; // from m_customStore
+
+    // Schema values from m_store, defaults for anything missing or invalid
+    void readValues();
+    void readCustomValues();
+    // Upgrade the file in memory to the current Meta/SchemaVersion
+    void runMigrations();
+    // Re-read files changed on disk and emit the differences
+    void reload();
+    // An atomic replace is a new file: watch it again
+    void watchFiles();
+
+    bool get(BoolKey key) const { return m_bools[std::size_t(key)]; }
+    int get(IntKey key) const { return m_ints[std::size_t(key)]; }
+    double get(DoubleKey key) const { return m_doubles[std::size_t(key)]; }
+    const QString &get(StringKey key) const { return m_strings[std::size_t(key)]; }
+    const QStringList &get(StringListKey key) const { return m_stringLists[std::size_t(key)]; }
+    QSize get(SizeKey key) const { return m_sizes[std::size_t(key)]; }
+    const QString &get(CustomKey key) const { return m_customs[std::size_t(key)]; }
+    void set(BoolKey key, bool value);
+    void set(IntKey key, int value);
+    void set(DoubleKey key, double value);
+    void set(StringKey key, const QString &value);
+    void set(StringListKey key, const QStringList &value);
+    void set(SizeKey key, const QSize &value);
+    void set(CustomKey key, const QString &value);
+
+    void setValue(const QString &key, const QVariant &value);
+    void setCustomValue(const QString &key, const QVariant &value);
 
     // Safe autostart handling
     void applyAutostart(bool enabled);
@@ -0,0 +1,249 @@
+// configschema.h
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <limits>
+
+// Every option in whatsit.ini and custom.ini: its type (which table it is
+// in), INI path and default. ConfigManager keeps the values in arrays indexed by
+// these enums, so a getter is an array read, not a string lookup.
+//
+// To add an option, add the enum value and the table row at the same
+// position; the static_asserts below catch a mismatch.
+namespace ConfigSchema {
+
+    constexpr int NO_MINIMUM = std::numeric_limits<int>::min();
+
+    enum class BoolKey {
+        RememberDownloadPaths,
+        ShowTrayTooltip,
+        MaximizedByDefault,
+        RememberWindowSize,
+        MinimizeToTray,
+        AutostartOnLogin,
+        StartMinimizedInTray,
+        ShowTrayIndicator,
+        SystemNotifications,
+        MuteAudio,
+        UseLessMemory,
+        ReactToSystemPressure,
+        DeepSleep,
+        SplitProcess,
+        ShowSnapshot,
+        SnapshotOnDisk,
+        PrewarmOnIntent,
+        PredictivePreload,
+        EnableFileLogging,
+        EnableTracing,
+        Count
+    };
+
+    enum class IntKey {
+        MemoryLimit,
+        MemoryLadderHysteresis,
+        BackgroundCheckInterval,
+        BackgroundCheckTimeout,
+        BackgroundCheckMaxInterval,
+        FreezeDelay,
+        DiscardDelay,
+        DeepSleepDelay,
+        StubIdleExit,
+        SnapshotMaxSize,
+        PrewarmTimeout,
+        PredictiveLead,
+        PredictiveWindow,
+        HttpCacheMaximumSize,
+        LogMaxSizeKb,
+        LogMaxFiles,
+        Count
+    };
+
+    enum class DoubleKey {
+        ZoomLevel,
+        Count
+    };
+
+    enum class StringKey {
+        HttpCacheType,
+        EngineProfile,
+        CustomChromiumFlags,
+        LogLevel,
+        LogCategories,
+        DownloadPath,
+        Count
+    };
+
+    enum class StringListKey {
+        MemoryLadder,
+        ConsoleFilters,
+        Count
+    };
+
+    enum class SizeKey {
+        WindowSize,
+        Count
+    };
+
+    // custom.ini, a file of its own so it can be pushed to a machine
+    enum class CustomKey {
+        Url,
+        TrayIcon,
+        AppIcon,
+        Count
+    };
+
+    struct BoolDef {
+        BoolKey key;
+        const char *path;
+        bool defaultValue;
+    };
+
+    struct IntDef {
+        IntKey key;
+        const char *path;
+        int defaultValue;
+        int minimum; // a stored value below this is replaced by the default
+    };
+
+    struct DoubleDef {
+        DoubleKey key;
+        const char *path;
+        double defaultValue;
+    };
+
+    struct StringDef {
+        StringKey key;
+        const char *path;
+        const char *defaultValue;
+    };
+
+    struct StringListDef {
+        StringListKey key;
+        const char *path;
+        const char *const *defaultValue; // nullptr-terminated; nullptr for an empty list
+    };
+
+    struct SizeDef {
+        SizeKey key;
+        const char *path;
+        int defaultWidth;
+        int defaultHeight;
+    };
+
+    struct CustomDef {
+        CustomKey key;
+        const char *path; // empty by default
+    };
+
+    inline constexpr BoolDef BOOL_KEYS[] = {
+        { BoolKey::RememberDownloadPaths, "General/RememberDownloadPaths", true },
+        { BoolKey::ShowTrayTooltip,       "General/ShowTrayTooltip", true },
+        { BoolKey::MaximizedByDefault,    "Window/MaximizedByDefault", false },
+        { BoolKey::RememberWindowSize,    "Window/RememberWindowSize", true },
+        { BoolKey::MinimizeToTray,        "Window/MinimizeToTray", true },
+        { BoolKey::AutostartOnLogin,      "System/AutostartOnLogin", false },
+        { BoolKey::StartMinimizedInTray,  "System/StartMinimizedInTray", false },
+        { BoolKey::ShowTrayIndicator,     "System/ShowTrayIndicator", true },
+        { BoolKey::SystemNotifications,   "System/SystemNotifications", true },
+        { BoolKey::MuteAudio,             "System/MuteAudio", false },
+        { BoolKey::UseLessMemory,         "Advanced/UseLessMemory", false },
+        { BoolKey::ReactToSystemPressure, "Advanced/ReactToSystemPressure", true },
+        { BoolKey::DeepSleep,             "Advanced/DeepSleep", false },
+        { BoolKey::SplitProcess,          "Advanced/SplitProcess", false },
+        { BoolKey::ShowSnapshot,          "Advanced/ShowSnapshot", true },
+        { BoolKey::SnapshotOnDisk,        "Advanced/SnapshotOnDisk", false },
+        { BoolKey::PrewarmOnIntent,       "Advanced/PrewarmOnIntent", true },
+        { BoolKey::PredictivePreload,     "Advanced/PredictivePreload", false },
+        { BoolKey::EnableFileLogging,     "Debug/EnableFileLogging", false },
+        { BoolKey::EnableTracing,         "Debug/EnableTracing", false },
+    };
+
+    inline constexpr IntDef INT_KEYS[] = {
+        { IntKey::MemoryLimit,                "Advanced/MemoryLimit", 0, NO_MINIMUM },           // GB, 0 = off
+        { IntKey::MemoryLadderHysteresis,     "Advanced/MemoryLadderHysteresis", 5, NO_MINIMUM }, // percent
+        { IntKey::BackgroundCheckInterval,    "Advanced/BackgroundCheckInterval", 0, NO_MINIMUM }, // minutes, 0 = off
+        { IntKey::BackgroundCheckTimeout,     "Advanced/BackgroundCheckTimeout", 60, 1 },        // seconds
+        { IntKey::BackgroundCheckMaxInterval, "Advanced/BackgroundCheckMaxInterval", 30, NO_MINIMUM }, // minutes
+        { IntKey::FreezeDelay,                "Advanced/FreezeDelay", 60, NO_MINIMUM },          // seconds
+        { IntKey::DiscardDelay,               "Advanced/DiscardDelay", 30, NO_MINIMUM },         // minutes, 0 = never
+        { IntKey::DeepSleepDelay,             "Advanced/DeepSleepDelay", 60, 1 },                // minutes
+        { IntKey::StubIdleExit,               "Advanced/StubIdleExit", 10, 1 },                  // minutes
+        { IntKey::SnapshotMaxSize,            "Advanced/SnapshotMaxSize", 512, 1 },              // KB
+        { IntKey::PrewarmTimeout,             "Advanced/PrewarmTimeout", 30, 1 },                // seconds
+        { IntKey::PredictiveLead,             "Advanced/PredictiveLead", 5, 1 },                 // minutes
+        { IntKey::PredictiveWindow,           "Advanced/PredictiveWindow", 20, 1 },              // minutes
+        { IntKey::HttpCacheMaximumSize,       "Cache/MaximumSize", 0, NO_MINIMUM },              // MB, 0 = Chromium default
+        { IntKey::LogMaxSizeKb,               "Debug/LogMaxSizeKb", 1024, 1 },
+        { IntKey::LogMaxFiles,                "Debug/LogMaxFiles", 3, 1 },
+    };
+
+    inline constexpr DoubleDef DOUBLE_KEYS[] = {
+        { DoubleKey::ZoomLevel, "Window/ZoomLevel", 1.0 },
+    };
+
+    inline constexpr StringDef STRING_KEYS[] = {
+        { StringKey::HttpCacheType,       "Cache/Type", "disk" },
+        { StringKey::EngineProfile,       "Engine/Profile", "balanced" },
+        { StringKey::CustomChromiumFlags, "Engine/CustomFlags", "" },
+        { StringKey::LogLevel,            "Debug/LogLevel", "" },
+        { StringKey::LogCategories,       "Debug/LogCategories", "all" },
+        { StringKey::DownloadPath,        "Downloads/DownloadPath", "" },            // empty: the Downloads folder
+    };
+
+    // Known noise from WhatsApp Web
+    inline constexpr const char *DEFAULT_CONSOLE_FILTERS[] = {
+        "Error with Permissions-Policy header",
+        "multiple-uim-roots",
+        "Subsequent non-fatal errors won't be logged",
+        nullptr
+    };
+
+    inline constexpr StringListDef STRING_LIST_KEYS[] = {
+        { StringListKey::MemoryLadder,   "Advanced/MemoryLadder", nullptr }, // "step:percent" pairs, see MemoryLadder::setSteps()
+        { StringListKey::ConsoleFilters, "Debug/ConsoleFilters", DEFAULT_CONSOLE_FILTERS }, // regexes
+    };
+
+    inline constexpr SizeDef SIZE_KEYS[] = {
+        { SizeKey::WindowSize, "Window/Size", 900, 600 },
+    };
+
+    inline constexpr CustomDef CUSTOM_KEYS[] = {
+        { CustomKey::Url,      "Custom/Url" },
+        { CustomKey::TrayIcon, "Custom/TrayIcon" },
+        { CustomKey::AppIcon,  "Custom/AppIcon" },
+    };
+
+    template <typename Def, std::size_t N>
+    constexpr bool inKeyOrder(const Def (&defs)[N])
+    {
+        for (std::size_t i = 0; i < N; ++i)
+            if (std::size_t(defs[i].key) != i)
+                return false;
+        return true;
+    }
+
+    static_assert(std::size(BOOL_KEYS) == std::size_t(BoolKey::Count) && inKeyOrder(BOOL_KEYS),
+                  "BOOL_KEYS must list every BoolKey in enum order");
+    static_assert(std::size(INT_KEYS) == std::size_t(IntKey::Count) && inKeyOrder(INT_KEYS),
+                  "INT_KEYS must list every IntKey in enum order");
+    static_assert(std::size(DOUBLE_KEYS) == std::size_t(DoubleKey::Count) && inKeyOrder(DOUBLE_KEYS),
+                  "DOUBLE_KEYS must list every DoubleKey in enum order");
+    static_assert(std::size(STRING_KEYS) == std::size_t(StringKey::Count) && inKeyOrder(STRING_KEYS),
+                  "STRING_KEYS must list every StringKey in enum order");
+    static_assert(std::size(STRING_LIST_KEYS) == std::size_t(StringListKey::Count) && inKeyOrder(STRING_LIST_KEYS),
+                  "STRING_LIST_KEYS must list every StringListKey in enum order");
+    static_assert(std::size(SIZE_KEYS) == std::size_t(SizeKey::Count) && inKeyOrder(SIZE_KEYS),
+                  "SIZE_KEYS must list every SizeKey in enum order");
+    static_assert(std::size(CUSTOM_KEYS) == std::size_t(CustomKey::Count) && inKeyOrder(CUSTOM_KEYS),
+                  "CUSTOM_KEYS must list every CustomKey in enum order");
+
+    constexpr const BoolDef &def(BoolKey key) { return BOOL_KEYS[std::size_t(key)]; }
+    constexpr const IntDef &def(IntKey key) { return INT_KEYS[std::size_t(key)]; }
+    constexpr const DoubleDef &def(DoubleKey key) { return DOUBLE_KEYS[std::size_t(key)]; }
+    constexpr const StringDef &def(StringKey key) { return STRING_KEYS[std::size_t(key)]; }
+    constexpr const StringListDef &def(StringListKey key) { return STRING_LIST_KEYS[std::size_t(key)]; }
+    constexpr const SizeDef &def(SizeKey key) { return SIZE_KEYS[std::size_t(key)]; }
+    constexpr const CustomDef &def(CustomKey key) { return CUSTOM_KEYS[std::size_t(key)]; }
+
+}
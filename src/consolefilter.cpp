@@ -0,0 +1,124 @@
+// consolefilter.cpp
+#include "consolefilter.h"
+#include "logger.h"
+
+namespace {
+
+    // Repeats are folded, and rate limit drops reported, per window
+    constexpr int WINDOW_MS = 10000;
+    // Distinct messages remembered per window; beyond this, repeats are logged again
+    constexpr int MAX_SEEN = 512;
+    // Token bucket per source and level
+    constexpr double BUCKET_BURST = 20;
+    constexpr double BUCKET_PER_SECOND = 2;
+    constexpr int SUMMARY_TEXT = 160;
+
+    QString shortened(const QString &text)
+    {
+        return text.size() > SUMMARY_TEXT ? text.left(SUMMARY_TEXT) + "..." : text;
+    }
+
+}
+
+ConsoleFilter::ConsoleFilter(QObject *parent)
+: QObject(parent)
+{
+    m_clock.start();
+    m_windowTimer.setSingleShot(true);
+    m_windowTimer.setInterval(WINDOW_MS);
+    connect(&m_windowTimer, &QTimer::timeout, this, &ConsoleFilter::closeWindow);
+}
+
+Logger::Level ConsoleFilter::logLevel(Level level)
+{
+    switch (level) {
+        case QWebEnginePage::ErrorMessageLevel:   return Logger::Level::Warning;
+        case QWebEnginePage::WarningMessageLevel: return Logger::Level::Info;
+        default:                                  return Logger::Level::Debug;
+    }
+}
+
+bool ConsoleFilter::wanted(Level level)
+{
+    const Logger::Level logged = logLevel(level);
+    return int(logged) >= WHATSIT_MIN_LOG_LEVEL && Logger::isEnabled(logged, Logger::Category::Console);
+}
+
+void ConsoleFilter::setFilters(const QStringList &patterns)
+{
+    QStringList parts;
+    for (const QString &pattern : patterns) {
+        if (pattern.isEmpty())
+            continue;
+        const QRegularExpression check(pattern);
+        if (!check.isValid()) {
+            Logger::log(Logger::Level::Warning, "ConsoleFilter: Ignoring invalid pattern '" + pattern + "': " + check.errorString());
+            continue;
+        }
+        parts << "(?:" + pattern + ")";
+    }
+
+    // An empty alternation would match everything
+    m_filter = parts.isEmpty() ? QRegularExpression() : QRegularExpression(parts.join('|'));
+    m_filter.optimize();
+}
+
+bool ConsoleFilter::handle(Level level, const QString &message, int lineNumber, const QString &sourceId)
+{
+    if (!m_filter.pattern().isEmpty() && m_filter.match(message).hasMatch())
+        return false;
+
+    // Repeats are counted before the rate limit, so they do not use it up
+    MessageKey messageKey { level, sourceId, message };
+    auto seen = m_seen.find(messageKey);
+    if (seen != m_seen.end()) {
+        ++*seen;
+        return false;
+    }
+
+    const BucketKey bucketKey { level, sourceId };
+    const qint64 now = m_clock.elapsed();
+    auto bucket = m_buckets.find(bucketKey);
+    if (bucket == m_buckets.end()) {
+        bucket = m_buckets.insert(bucketKey, Bucket { BUCKET_BURST, now, 0 });
+    } else {
+        bucket->tokens = qMin(BUCKET_BURST, bucket->tokens + (now - bucket->refilledMs) * BUCKET_PER_SECOND / 1000.0);
+        bucket->refilledMs = now;
+    }
+    if (bucket->tokens < 1) {
+        bucket->dropped++;
+        if (!m_windowTimer.isActive())
+            m_windowTimer.start();
+        return false;
+    }
+    bucket->tokens -= 1;
+
+    if (m_seen.size() < MAX_SEEN)
+        m_seen.insert(std::move(messageKey), 0);
+    if (!m_windowTimer.isActive())
+        m_windowTimer.start();
+
+    Logger::log(logLevel(level), QString("JS Console: %1 (Line %2, Source: %3)").arg(message).arg(lineNumber).arg(sourceId));
+    return true;
+}
+
+void ConsoleFilter::closeWindow()
+{
+    for (auto it = m_seen.cbegin(); it != m_seen.cend(); ++it) {
+        if (it.value() > 0)
+            Logger::log(logLevel(it.key().level), QString("JS Console: Repeated %1 more times: %2").arg(it.value()).arg(shortened(it.key().message)));
+    }
+    m_seen.clear();
+
+    for (auto it = m_buckets.begin(); it != m_buckets.end();) {
+        if (it->dropped > 0) {
+            Logger::log(logLevel(it.key().level), QString("JS Console: Rate limited %1 messages from %2").arg(it->dropped).arg(it.key().source));
+            it->dropped = 0;
+        }
+        // Full buckets carry no state worth keeping
+        if (it->tokens + (m_clock.elapsed() - it->refilledMs) * BUCKET_PER_SECOND / 1000.0 >= BUCKET_BURST)
+            it = m_buckets.erase(it);
+        else
+            ++it;
+    }
+}
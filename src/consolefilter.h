@@ -0,0 +1,86 @@
+// consolefilter.h
+#pragma once
+
+#include "logger.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QRegularExpression>
+#include <QTimer>
+#include <QWebEnginePage>
+
+// Sits between the page's JavaScript console and the log. WhatsApp Web can
+// print hundreds of lines while it syncs, most of them repeats:
+//  - messages matching a configured pattern are dropped,
+//  - a message already seen in the current window is only counted, and
+//    reported once with its count when the window closes,
+//  - each source and level gets a token bucket, so one noisy script
+//    cannot flood the log.
+class ConsoleFilter : public QObject
+{
+    Q_OBJECT
+public:
+    using Level = QWebEnginePage::JavaScriptConsoleMessageLevel;
+
+    explicit ConsoleFilter(QObject *parent = nullptr);
+
+    // Errors are logged as warnings and warnings as info, so builds with
+    // debug compiled out keep them; plain console.log lines are debug
+    static Logger::Level logLevel(Level level);
+    // Compiled in, and enabled for the Console category right now
+    static bool wanted(Level level);
+
+    // Regular expressions; compiled once into a single pattern
+    void setFilters(const QStringList &patterns);
+
+    // False if the message was filtered, folded into a repeat or rate limited
+    bool handle(Level level, const QString &message, int lineNumber, const QString &sourceId);
+
+private slots:
+    void closeWindow();
+
+private:
+    // The strings themselves, not their hash: a collision would fold a
+    // different message into a repeat
+    struct MessageKey {
+        Level level;
+        QString source;
+        QString message;
+
+        friend bool operator==(const MessageKey &a, const MessageKey &b)
+        {
+            return a.level == b.level && a.source == b.source && a.message == b.message;
+        }
+        friend size_t qHash(const MessageKey &key, size_t seed = 0)
+        {
+            return qHashMulti(seed, int(key.level), key.source, key.message);
+        }
+    };
+
+    struct BucketKey {
+        Level level;
+        QString source;
+
+        friend bool operator==(const BucketKey &a, const BucketKey &b)
+        {
+            return a.level == b.level && a.source == b.source;
+        }
+        friend size_t qHash(const BucketKey &key, size_t seed = 0)
+        {
+            return qHashMulti(seed, int(key.level), key.source);
+        }
+    };
+
+    struct Bucket {
+        double tokens = 0;
+        qint64 refilledMs = 0;
+        int dropped = 0;
+    };
+
+    QRegularExpression m_filter;
+    QHash<MessageKey, int> m_seen; // repeats beyond the first, which was logged
+    QHash<BucketKey, Bucket> m_buckets;
+    QTimer m_windowTimer;
+    QElapsedTimer m_clock;
+};
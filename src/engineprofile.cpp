@@ -0,0 +1,122 @@
+// engineprofile.cpp
+#include "engineprofile.h"
+#include "configmanager.h"
+#include "logger.h"
+
+#include <QtGlobal>
+
+namespace {
+
+    // QTWEBENGINE_CHROMIUM_FLAGS as the user exported it
+    const char USER_FLAGS_VARIABLE[] = "WHATSIT_USER_CHROMIUM_FLAGS";
+
+    // Switches whose comma separated values are combined instead of replaced
+    const QStringList LIST_SWITCHES = {
+        "--enable-features",
+        "--disable-features",
+    };
+
+    QString switchName(const QString &flag)
+    {
+        const int eq = flag.indexOf('=');
+        return eq < 0 ? flag : flag.left(eq);
+    }
+
+    // Later flags override earlier ones with the same name;
+    // feature lists are concatenated.
+    QStringList merge(const QStringList &flags)
+    {
+        QStringList result;
+        for (const QString &flag : flags) {
+            const QString name = switchName(flag);
+            int existing = -1;
+            for (int i = 0; i < result.size(); ++i) {
+                if (switchName(result.at(i)) == name) {
+                    existing = i;
+                    break;
+                }
+            }
+
+            if (existing < 0) {
+                result.append(flag);
+            } else if (LIST_SWITCHES.contains(name)) {
+                QStringList values = result.at(existing).mid(name.size() + 1).split(',', Qt::SkipEmptyParts);
+                for (const QString &value : flag.mid(name.size() + 1).split(',', Qt::SkipEmptyParts)) {
+                    if (!values.contains(value))
+                        values.append(value);
+                }
+                result[existing] = name + "=" + values.join(',');
+            } else {
+                result[existing] = flag;
+            }
+        }
+        return result;
+    }
+
+}
+
+QStringList EngineProfile::names()
+{
+    return { "balanced", "low-memory", "low-cpu", "custom" };
+}
+
+QString EngineProfile::defaultName()
+{
+    return "balanced";
+}
+
+QStringList EngineProfile::flags(const QString &profile, const QString &customFlags)
+{
+    if (profile == "custom")
+        return customFlags.split(' ', Qt::SkipEmptyParts);
+
+    if (profile == "low-memory") {
+        return {
+            "--renderer-process-limit=1",
+            "--process-per-site",
+            "--js-flags=--max-old-space-size=512",
+            "--enable-low-end-device-mode",
+            "--disable-background-networking",
+            "--disable-features=BackForwardCache,SpareRendererForSitePerProcess",
+        };
+    }
+
+    if (profile == "low-cpu") {
+        return {
+            "--renderer-process-limit=1",
+            "--num-raster-threads=1",
+            "--disable-smooth-scrolling",
+            "--disable-background-networking",
+            "--disable-features=BackForwardCache,MediaRouter",
+        };
+    }
+
+    // balanced: one WhatsApp page plus the odd popup
+    return {
+        "--renderer-process-limit=2",
+        "--num-raster-threads=2",
+    };
+}
+
+void EngineProfile::apply(const ConfigManager &config)
+{
+    QString profile = config.engineProfile();
+    if (!names().contains(profile)) {
+        Logger::log("EngineProfile: Unknown profile '" + profile + "', using " + defaultName());
+        profile = defaultName();
+    }
+
+    QStringList all = flags(profile, config.customChromiumFlags());
+
+    // Our own export is inherited by the processes we start; only the first
+    // process sees what the user set, and keeps it aside for the others
+    if (!qEnvironmentVariableIsSet(USER_FLAGS_VARIABLE))
+        qputenv(USER_FLAGS_VARIABLE, qgetenv("QTWEBENGINE_CHROMIUM_FLAGS"));
+    const QString external = qEnvironmentVariable(USER_FLAGS_VARIABLE);
+    all += external.split(' ', Qt::SkipEmptyParts);
+
+    const QString effective = merge(all).join(' ');
+    qputenv("QTWEBENGINE_CHROMIUM_FLAGS", effective.toLocal8Bit());
+
+    Logger::log("EngineProfile: " + profile + " -> " + (effective.isEmpty() ? "(Chromium defaults)" : effective));
+}
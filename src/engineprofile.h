@@ -0,0 +1,25 @@
+// engineprofile.h
+#pragma once
+
+#include <QStringList>
+
+class ConfigManager;
+
+// Named sets of Chromium switches for Qt WebEngine.
+// Must be applied before QApplication is constructed: WebEngine reads
+// QTWEBENGINE_CHROMIUM_FLAGS once, when it starts.
+namespace EngineProfile {
+
+    // "balanced", "low-memory", "low-cpu", "custom"
+    QStringList names();
+    QString defaultName();
+
+    // Switches for a profile; "custom" uses customFlags only
+    QStringList flags(const QString &profile, const QString &customFlags);
+
+    // Merge the profile with the user's own QTWEBENGINE_CHROMIUM_FLAGS
+    // (hand exports win) and export the result. Safe to repeat in child
+    // processes: the user's flags are kept in WHATSIT_USER_CHROMIUM_FLAGS.
+    void apply(const ConfigManager &config);
+
+}
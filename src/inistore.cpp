@@ -0,0 +1,150 @@
+// inistore.cpp
+#include "inistore.h"
+#include "logger.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QSettings>
+#include <QStringList>
+
+namespace {
+
+    // What QSettings hands back for a value once it has been through the
+    // file: numbers and booleans come back as strings, lists as string
+    // lists. Lets "true" read from disk equal bool true.
+    QVariant asReadBack(const QVariant &value)
+    {
+        switch (value.typeId()) {
+            case QMetaType::Bool:
+            case QMetaType::Int:
+            case QMetaType::UInt:
+            case QMetaType::LongLong:
+            case QMetaType::ULongLong:
+            case QMetaType::Double:
+            case QMetaType::QByteArray:
+                return value.toString();
+            case QMetaType::QVariantList:
+                return value.toStringList();
+            default:
+                return value;
+        }
+    }
+
+}
+
+void IniStore::read(const QString &path)
+{
+    m_path = path;
+    stamp();
+    m_values = parse(path);
+    m_changed.clear();
+}
+
+bool IniStore::write()
+{
+    if (m_changed.isEmpty())
+        return true;
+
+    // QSettings re-reads the file under its lock, applies only the keys
+    // set or removed here and replaces the file atomically
+    QDir().mkpath(QFileInfo(m_path).absolutePath());
+    QSettings settings(m_path, QSettings::IniFormat);
+    for (const QString &key : std::as_const(m_changed)) {
+        auto it = m_values.constFind(key);
+        if (it != m_values.constEnd())
+            settings.setValue(key, it.value());
+        else
+            settings.remove(key);
+    }
+    settings.sync();
+    if (settings.status() != QSettings::NoError) {
+        Logger::log(Logger::Level::Warning, "IniStore: Cannot write " + m_path);
+        return false;
+    }
+
+    m_changed.clear();
+    stamp();
+    m_values = parse(m_path);
+    return true;
+}
+
+bool IniStore::refresh()
+{
+    if (!isStale())
+        return false;
+
+    // Stamped before parsing: a write racing the parse triggers another refresh
+    stamp();
+    m_values = mergedWithDisk();
+    return true;
+}
+
+QVariant IniStore::value(const QString &key, const QVariant &defaultValue) const
+{
+    return m_values.value(key, defaultValue);
+}
+
+bool IniStore::setValue(const QString &key, const QVariant &value)
+{
+    auto it = m_values.constFind(key);
+    if (it != m_values.constEnd() && asReadBack(it.value()) == asReadBack(value))
+        return false;
+
+    m_values.insert(key, value);
+    m_changed.insert(key);
+    return true;
+}
+
+void IniStore::remove(const QString &key)
+{
+    if (m_values.remove(key) > 0)
+        m_changed.insert(key);
+}
+
+void IniStore::clear()
+{
+    m_values.clear();
+    m_changed.clear();
+}
+
+QMap<QString, QVariant> IniStore::mergedWithDisk() const
+{
+    // Only our own changes win; anything else on disk may be newer
+    QMap<QString, QVariant> merged = parse(m_path);
+    for (const QString &key : std::as_const(m_changed)) {
+        auto it = m_values.constFind(key);
+        if (it != m_values.constEnd())
+            merged.insert(key, it.value());
+        else
+            merged.remove(key);
+    }
+    return merged;
+}
+
+void IniStore::stamp()
+{
+    const QFileInfo info(m_path);
+    m_modified = info.exists() ? info.lastModified() : QDateTime();
+    m_size = info.exists() ? info.size() : -1;
+}
+
+bool IniStore::isStale() const
+{
+    const QFileInfo info(m_path);
+    if (!info.exists())
+        return m_size >= 0;
+    return info.lastModified() != m_modified || info.size() != m_size;
+}
+
+QMap<QString, QVariant> IniStore::parse(const QString &path)
+{
+    QMap<QString, QVariant> values;
+    if (!QFileInfo::exists(path))
+        return values;
+
+    QSettings settings(path, QSettings::IniFormat);
+    const QStringList keys = settings.allKeys();
+    for (const QString &key : keys)
+        values.insert(key, settings.value(key));
+    return values;
+}
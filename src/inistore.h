@@ -0,0 +1,48 @@
+// inistore.h
+#pragma once
+
+#include <QDateTime>
+#include <QMap>
+#include <QSet>
+#include <QString>
+#include <QVariant>
+
+// An INI file held in memory. read() parses it once; value() and
+// setValue() never touch the disk. write() hands only the keys changed
+// here to QSettings, which puts them on top of whatever is on disk now
+// (another process may share the file) and replaces the file atomically.
+class IniStore
+{
+public:
+    // Missing file: start empty
+    void read(const QString &path);
+    // Does nothing when there is nothing to write
+    bool write();
+    // Re-read if the file is not the one we last read or wrote; local changes
+    // not yet written stay on top. False if the file was unchanged.
+    bool refresh();
+
+    QString path() const { return m_path; }
+    bool contains(const QString &key) const { return m_values.contains(key); }
+    QVariant value(const QString &key, const QVariant &defaultValue = QVariant()) const;
+    // False if the value was already stored
+    bool setValue(const QString &key, const QVariant &value);
+    void remove(const QString &key);
+    // Forget everything, e.g. after the file has been deleted
+    void clear();
+    bool isDirty() const { return !m_changed.isEmpty(); }
+
+private:
+    static QMap<QString, QVariant> parse(const QString &path);
+    // The file now, with our unwritten changes applied
+    QMap<QString, QVariant> mergedWithDisk() const;
+    void stamp();
+    bool isStale() const;
+
+    QString m_path;
+    // File as of our last read or write; lets refresh() skip our own writes
+    QDateTime m_modified;
+    qint64 m_size = -1;
+    QMap<QString, QVariant> m_values;
+    QSet<QString> m_changed; // set or removed since the last write
+};
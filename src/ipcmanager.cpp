@@ -1,67 +1,97 @@
 // ipcmanager.cpp
 #include "ipcmanager.h"
 #include "logger.h"
+#include "trace.h"
 
-#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
 #include <QLocalSocket>
 #include <QUrl>
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
 
-static constexpr const char *IPC_NAME = "whatsit-ipc";
+namespace {
 
-IpcManager::IpcManager(QObject *parent) : QObject(parent) {}
+    // Same wait QLocalSocket::waitForConnected() was given
+    constexpr int CONNECT_TIMEOUT_MS = 100;
 
-bool IpcManager::notifyExistingInstance(const QString &command) {
-    Logger::log("Checking for existing instance...");
+}
 
-    QStringList args = QCoreApplication::arguments();
-    // Debug: Log all arguments for debugging
-    /*
-    // for (const auto& arg : args) {
-    //      Logger::log("Raw Arg: " + arg);
-    // }
-    */
+IpcManager::IpcManager(QObject *parent) : QObject(parent) {}
 
-    QLocalSocket socket;
-    socket.connectToServer(IPC_NAME);
+bool IpcManager::notifyExistingInstance(const QString &command, const QString &url) {
+    Logger::log("Checking for existing instance...");
 
-    if (!socket.waitForConnected(100))
-        return false; // No running instance
+    // Where QLocalServer::listen() puts a name that is not a path
+    const QByteArray path = QFile::encodeName(QDir::tempPath() + '/' + MainServer);
+    sockaddr_un address {};
+    if (path.size() >= qsizetype(sizeof(address.sun_path)))
+        return false;
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.constData(), path.size());
+
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return false;
+
+    // Only a full accept backlog can make connect() wait
+    const timeval timeout { 0, CONNECT_TIMEOUT_MS * 1000 };
+    ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    // No instance: no socket file (ENOENT) or a stale one (ECONNREFUSED)
+    if (::connect(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        return false;
+    }
 
     Logger::log("Existing instance found.");
 
-    QString message = command;
-    bool hasUrl = false;
-
-    // Check for URL argument
-    for (int i = 1; i < args.size(); ++i) {
-        if (args[i].startsWith("http") || args[i].startsWith("whatsapp")) {
-            message += "|" + args[i];
-            hasUrl = true;
-            // Debug:
-            // Logger::log("Found URL argument: " + args[i]);
+    QByteArray message = command.toUtf8();
+    if (!url.isEmpty())
+        message += '|' + url.toUtf8();
+
+    const char *data = message.constData();
+    qsizetype remaining = message.size();
+    while (remaining > 0) {
+        const ssize_t written = ::send(fd, data, remaining, MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            Logger::log(Logger::Level::Warning, QString("Could not notify existing instance: %1").arg(std::strerror(errno)));
             break;
         }
+        data += written;
+        remaining -= written;
     }
+    ::close(fd);
 
-    if (command == "raise" || command == "hide" || hasUrl) {
-        // Debug:
-        // Logger::log("Sending IPC message: " + message);
-        socket.write(message.toUtf8());
-        socket.flush();
-        socket.waitForBytesWritten(100);
-    }
-    
+    return true;
+}
+
+bool IpcManager::sendMessage(const QString &serverName, const QString &message) {
+    QLocalSocket socket;
+    socket.connectToServer(serverName);
+
+    if (!socket.waitForConnected(100))
+        return false;
+
+    socket.write(message.toUtf8());
+    socket.flush();
+    socket.waitForBytesWritten(100);
     socket.disconnectFromServer();
 
     return true;
 }
 
-void IpcManager::start() {
-    Logger::log("Starting IPC server...");
+void IpcManager::start(const QString &serverName) {
+    Logger::log("Starting IPC server " + serverName + "...");
     // Clean up stale socket (crash-safe)
-    QLocalServer::removeServer(IPC_NAME);
+    QLocalServer::removeServer(serverName);
 
-    server.listen(IPC_NAME);
+    server.listen(serverName);
 
     connect(&server, &QLocalServer::newConnection, this, [&] {
         auto *s = server.nextPendingConnection();
@@ -74,13 +104,36 @@ void IpcManager::start() {
             QStringList parts = message.split('|'); // split using '|'
             if (!parts.isEmpty()) {
                 QString cmd = parts[0];
+                TRACE_SCOPE("ipc-message");
+                Trace::instant("ipc-received", cmd.left(16));
+                const bool flag = parts.value(1) == "1";
+                bool mayCarryUrl = true;
                 if (cmd == "raise") {
                     emit raiseRequested();
                 } else if (cmd == "hide") {
                     emit hideRequested();
+                } else if (cmd == "toggle") {
+                    emit toggleRequested();
+                } else if (cmd == "check") {
+                    emit checkRequested();
+                } else if (cmd == "prewarm") {
+                    emit prewarmRequested();
+                } else if (cmd == "quit") {
+                    emit quitRequested();
+                } else if (cmd == "restart") {
+                    emit restartRequested();
+                } else if (cmd == "unread") {
+                    emit unreadReported(flag);
+                    mayCarryUrl = false;
+                } else if (cmd == "visible") {
+                    emit visibilityReported(flag);
+                    mayCarryUrl = false;
+                } else if (cmd == "checked") {
+                    emit checkFinished(flag);
+                    mayCarryUrl = false;
                 }
 
-                if (parts.size() > 1) {
+                if (mayCarryUrl && parts.size() > 1) {
                     QUrl url(parts[1]);
                     if (url.isValid()) {
                         // Logger::log("IPC URL request: " + url.toString());
@@ -8,20 +8,40 @@ class IpcManager : public QObject
 {
     Q_OBJECT
 public:
+    // Main instance (or the tray stub in split-process mode)
+    static constexpr const char *MainServer = "whatsit-ipc";
+    // WebEngine UI process started by the tray stub
+    static constexpr const char *UiServer = "whatsit-ui-ipc";
+
     explicit IpcManager(QObject *parent = nullptr);
 
     // Start IPC server (called by main instance)
-    void start();
+    void start(const QString &serverName = MainServer);
+
+    // Client-side helper, for main() before QApplication exists: a plain
+    // Unix socket, no event loop. Sends "command|url" (url optional).
+    // Returns true if another instance was found and notified.
+    static bool notifyExistingInstance(const QString &command, const QString &url = QString());
 
-    // Client-side helper:
-    // returns true if another instance was found and notified
-    static bool notifyExistingInstance(const QString &command = "raise");
+    // Send one message to a server; false if nobody is listening
+    static bool sendMessage(const QString &serverName, const QString &message);
 
 signals:
     void raiseRequested();
     void hideRequested();
     void openUrlRequested(const QUrl &url);
 
+    // Split-process mode: stub -> UI
+    void toggleRequested();
+    void checkRequested();
+    void prewarmRequested();
+    // Split-process mode: UI -> stub
+    void unreadReported(bool hasUnread);
+    void visibilityReported(bool visible);
+    void checkFinished(bool foundActivity);
+    void quitRequested();
+    void restartRequested();
+
 private:
     QLocalServer server;
 };
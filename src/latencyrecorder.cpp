@@ -0,0 +1,280 @@
+// latencyrecorder.cpp
+#include "latencyrecorder.h"
+#include "logger.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMutex>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QStringList>
+#include <QThread>
+#include <QtAlgorithms>
+#include <algorithm>
+#include <iomanip>
+#include <unistd.h>
+
+namespace {
+
+    constexpr quint32 FILE_MAGIC = 0x574c4831; // "WLH1"
+    constexpr int SUB_BUCKET_BITS = 4;
+    constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+
+    using HistogramKey = QPair<QString, QString>; // phase, context
+    using HistogramMap = QMap<HistogramKey, LatencyHistogram>;
+
+    QMutex s_mutex;
+    HistogramMap s_pending;
+    QString s_context = "default";
+    QElapsedTimer s_sinceMain;
+    qint64 s_execToMainMs = 0;
+
+    // How long the process existed before main() ran: dynamic linking and
+    // static initialisers, which for Qt WebEngine are not free
+    qint64 readExecToMain()
+    {
+        QFile stat("/proc/self/stat");
+        QFile uptime("/proc/uptime");
+        if (!stat.open(QIODevice::ReadOnly) || !uptime.open(QIODevice::ReadOnly))
+            return 0;
+
+        // Field 22 is starttime; comm (field 2) may contain spaces, skip past ')'
+        const QByteArray statLine = stat.readAll();
+        const QList<QByteArray> fields = statLine.mid(statLine.lastIndexOf(')') + 2).split(' ');
+        if (fields.size() < 20)
+            return 0;
+
+        const double startTicks = fields.at(19).toDouble();
+        const double uptimeSec = uptime.readAll().split(' ').value(0).toDouble();
+        const long ticksPerSec = sysconf(_SC_CLK_TCK);
+        if (ticksPerSec <= 0)
+            return 0;
+
+        return qMax<qint64>(0, qint64((uptimeSec - startTicks / ticksPerSec) * 1000.0));
+    }
+
+    bool readFile(const QString &path, HistogramMap &map)
+    {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly))
+            return false;
+
+        QDataStream in(&file);
+        quint32 magic = 0;
+        quint32 entries = 0;
+        in >> magic >> entries;
+        if (magic != FILE_MAGIC)
+            return false;
+
+        for (quint32 i = 0; i < entries && in.status() == QDataStream::Ok; ++i) {
+            QString phase;
+            QString context;
+            quint32 buckets = 0;
+            in >> phase >> context >> buckets;
+
+            LatencyHistogram &histogram = map[qMakePair(phase, context)];
+            for (quint32 b = 0; b < buckets && in.status() == QDataStream::Ok; ++b) {
+                qint32 bucket = 0;
+                quint32 count = 0;
+                in >> bucket >> count;
+                histogram.add(LatencyHistogram::bucketUpperBound(bucket), count);
+            }
+        }
+        return in.status() == QDataStream::Ok;
+    }
+
+}
+
+// ---------------- LatencyHistogram ----------------
+
+int LatencyHistogram::bucketOf(qint64 value)
+{
+    if (value < SUB_BUCKETS)
+        return int(qMax<qint64>(0, value));
+
+    // value lies in [2^k, 2^(k+1)), k >= SUB_BUCKET_BITS
+    const int k = 63 - int(qCountLeadingZeroBits(quint64(value)));
+    const int sub = int(value >> (k - SUB_BUCKET_BITS)) - SUB_BUCKETS;
+    return SUB_BUCKETS + (k - SUB_BUCKET_BITS) * SUB_BUCKETS + sub;
+}
+
+qint64 LatencyHistogram::bucketUpperBound(int bucket)
+{
+    if (bucket < SUB_BUCKETS)
+        return bucket;
+
+    const int k = (bucket - SUB_BUCKETS) / SUB_BUCKETS + SUB_BUCKET_BITS;
+    const int sub = (bucket - SUB_BUCKETS) % SUB_BUCKETS;
+    const qint64 width = qint64(1) << (k - SUB_BUCKET_BITS);
+    return (qint64(SUB_BUCKETS + sub) << (k - SUB_BUCKET_BITS)) + width - 1;
+}
+
+void LatencyHistogram::add(qint64 value, quint32 count)
+{
+    m_buckets[bucketOf(value)] += count;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other)
+{
+    for (auto it = other.m_buckets.cbegin(); it != other.m_buckets.cend(); ++it)
+        m_buckets[it.key()] += it.value();
+}
+
+quint64 LatencyHistogram::count() const
+{
+    quint64 total = 0;
+    for (quint32 c : m_buckets)
+        total += c;
+    return total;
+}
+
+qint64 LatencyHistogram::percentile(double percent) const
+{
+    const quint64 total = count();
+    if (total == 0)
+        return 0;
+
+    const quint64 rank = qMax<quint64>(1, quint64(total * percent / 100.0 + 0.5));
+    quint64 seen = 0;
+    for (auto it = m_buckets.cbegin(); it != m_buckets.cend(); ++it) {
+        seen += it.value();
+        if (seen >= rank)
+            return bucketUpperBound(it.key());
+    }
+    return max();
+}
+
+qint64 LatencyHistogram::max() const
+{
+    return m_buckets.isEmpty() ? 0 : bucketUpperBound(m_buckets.lastKey());
+}
+
+// ---------------- LatencyRecorder ----------------
+
+void LatencyRecorder::processStarted()
+{
+    s_sinceMain.start();
+    s_execToMainMs = readExecToMain();
+    record("startup.exec-to-main", s_execToMainMs);
+}
+
+qint64 LatencyRecorder::sinceProcessStart()
+{
+    return s_execToMainMs + (s_sinceMain.isValid() ? s_sinceMain.elapsed() : 0);
+}
+
+void LatencyRecorder::setContext(const QString &context)
+{
+    QMutexLocker lock(&s_mutex);
+
+    // Samples taken before the context was known (startup) belong to it too
+    if (s_context != context) {
+        HistogramMap moved;
+        for (auto it = s_pending.cbegin(); it != s_pending.cend(); ++it)
+            moved[qMakePair(it.key().first, context)].merge(it.value());
+        s_pending = moved;
+    }
+    s_context = context;
+}
+
+QString LatencyRecorder::defaultContext(const QString &engineProfile)
+{
+    // Hardware class: cores and RAM rounded to whole GB
+    const long pages = sysconf(_SC_PHYS_PAGES);
+    const long pageSize = sysconf(_SC_PAGE_SIZE);
+    const qint64 ramGb = pages > 0 && pageSize > 0 ? (qint64(pages) * pageSize + (512LL << 20)) >> 30 : 0;
+
+    return QString("%1/%2c-%3g/%4")
+        .arg(engineProfile)
+        .arg(QThread::idealThreadCount())
+        .arg(ramGb)
+        .arg(QStringLiteral(WHATSIT_VERSION));
+}
+
+void LatencyRecorder::record(const QString &phase, qint64 ms)
+{
+    QMutexLocker lock(&s_mutex);
+    s_pending[qMakePair(phase, s_context)].add(ms);
+}
+
+bool LatencyRecorder::save()
+{
+    HistogramMap pending;
+    {
+        QMutexLocker lock(&s_mutex);
+        pending.swap(s_pending);
+    }
+    if (pending.isEmpty())
+        return true;
+
+    // Merge with what earlier runs (or another process) wrote
+    const QString path = filePath();
+    HistogramMap merged;
+    readFile(path, merged);
+    for (auto it = pending.cbegin(); it != pending.cend(); ++it)
+        merged[it.key()].merge(it.value());
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        Logger::log("LatencyRecorder: Cannot write " + path);
+        return false;
+    }
+
+    QDataStream out(&file);
+    out << FILE_MAGIC << quint32(merged.size());
+    for (auto it = merged.cbegin(); it != merged.cend(); ++it) {
+        out << it.key().first << it.key().second << quint32(it.value().buckets().size());
+        const QMap<int, quint32> &buckets = it.value().buckets();
+        for (auto b = buckets.cbegin(); b != buckets.cend(); ++b)
+            out << qint32(b.key()) << b.value();
+    }
+    return file.commit();
+}
+
+int LatencyRecorder::dump(std::ostream &out)
+{
+    HistogramMap map;
+    const QString path = filePath();
+    if (!readFile(path, map)) {
+        out << "No latency data in " << path.toStdString() << std::endl;
+        return 1;
+    }
+
+    out << "Latency (ms) from " << path.toStdString() << "\n\n";
+
+    QString lastContext;
+    // Group by context, so releases and profiles line up
+    QList<HistogramKey> keys = map.keys();
+    std::sort(keys.begin(), keys.end(), [](const HistogramKey &a, const HistogramKey &b) {
+        return a.second != b.second ? a.second < b.second : a.first < b.first;
+    });
+
+    for (const HistogramKey &key : keys) {
+        if (key.second != lastContext) {
+            out << key.second.toStdString() << "\n";
+            out << "  " << std::left << std::setw(30) << "phase" << std::right
+                << std::setw(8) << "count" << std::setw(9) << "p50" << std::setw(9) << "p90"
+                << std::setw(9) << "p99" << std::setw(9) << "max" << "\n";
+            lastContext = key.second;
+        }
+
+        const LatencyHistogram &h = map.value(key);
+        out << "  " << std::left << std::setw(30) << key.first.toStdString() << std::right
+            << std::setw(8) << h.count()
+            << std::setw(9) << h.percentile(50)
+            << std::setw(9) << h.percentile(90)
+            << std::setw(9) << h.percentile(99)
+            << std::setw(9) << h.max() << "\n";
+    }
+    out << std::flush;
+    return 0;
+}
+
+QString LatencyRecorder::filePath()
+{
+    const QString dataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QDir().mkpath(dataPath);
+    return dataPath + "/latency.dat";
+}
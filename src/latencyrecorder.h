@@ -0,0 +1,54 @@
+// latencyrecorder.h
+#pragma once
+
+#include <QMap>
+#include <QString>
+#include <ostream>
+
+// Log-linear histogram in the style of HdrHistogram: values below 16 are
+// exact, above that every power of two is split into 16 linear buckets,
+// so any reported percentile is within 6.25% of the true value.
+class LatencyHistogram
+{
+public:
+    void add(qint64 value, quint32 count = 1);
+    void merge(const LatencyHistogram &other);
+
+    quint64 count() const;
+    // Upper bound of the bucket holding the given percentile (0-100)
+    qint64 percentile(double percent) const;
+    qint64 max() const;
+
+    const QMap<int, quint32> &buckets() const { return m_buckets; }
+
+    static int bucketOf(qint64 value);
+    static qint64 bucketUpperBound(int bucket);
+
+private:
+    QMap<int, quint32> m_buckets; // sparse: most phases use a few buckets
+};
+
+// Per-phase startup and show latencies in milliseconds. Samples are kept
+// per context (engine profile, hardware class, build) and merged into a
+// file in the app data dir by save(), so they add up across runs.
+// `whatsit latency` prints them.
+class LatencyRecorder
+{
+public:
+    // Call first thing in main(); also records exec -> main()
+    static void processStarted();
+    // Milliseconds since the process was exec'd
+    static qint64 sinceProcessStart();
+
+    static void setContext(const QString &context);
+    static QString defaultContext(const QString &engineProfile);
+
+    static void record(const QString &phase, qint64 ms);
+
+    // Merge this run's samples into the file. Safe to call more than once.
+    static bool save();
+    static int dump(std::ostream &out);
+
+private:
+    static QString filePath();
+};
@@ -0,0 +1,43 @@
+// leaninterceptor.cpp
+#include "leaninterceptor.h"
+
+LeanRequestInterceptor::LeanRequestInterceptor(QObject *parent)
+: QWebEngineUrlRequestInterceptor(parent)
+{
+}
+
+void LeanRequestInterceptor::interceptRequest(QWebEngineUrlRequestInfo &info)
+{
+    if (!m_enabled.load(std::memory_order_relaxed))
+        return;
+
+    switch (info.resourceType()) {
+        case QWebEngineUrlRequestInfo::ResourceTypeFavicon:
+            m_favicons++;
+            break;
+        case QWebEngineUrlRequestInfo::ResourceTypeMedia:
+            m_media++;
+            break;
+        default:
+            return;
+    }
+    info.block(true);
+}
+
+void LeanRequestInterceptor::setEnabled(bool enabled)
+{
+    m_enabled = enabled;
+}
+
+bool LeanRequestInterceptor::isEnabled() const
+{
+    return m_enabled;
+}
+
+LeanRequestInterceptor::Counts LeanRequestInterceptor::takeCounts()
+{
+    Counts counts;
+    counts.favicons = m_favicons.exchange(0);
+    counts.media = m_media.exchange(0);
+    return counts;
+}
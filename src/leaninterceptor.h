@@ -0,0 +1,38 @@
+// leaninterceptor.h
+#pragma once
+
+#include <QWebEngineUrlRequestInterceptor>
+#include <atomic>
+
+// Blocks requests a background check does not need (media, favicons)
+// while enabled. Images are left to AutoLoadImages, which defers them and
+// loads them all, CSS backgrounds included, once it is turned back on;
+// blocking them here would leave them broken. Fonts are never blocked: icon
+// fonts would stay broken until a reload. Scripts, XHR and websockets are
+// never touched, so unread state and notifications still arrive.
+class LeanRequestInterceptor : public QWebEngineUrlRequestInterceptor
+{
+    Q_OBJECT
+public:
+    struct Counts {
+        int favicons = 0;
+        int media = 0;
+
+        int total() const { return favicons + media; }
+    };
+
+    explicit LeanRequestInterceptor(QObject *parent = nullptr);
+
+    void interceptRequest(QWebEngineUrlRequestInfo &info) override;
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    // Counts since the last call
+    Counts takeCounts();
+
+private:
+    std::atomic_bool m_enabled { false };
+    std::atomic_int m_favicons { 0 };
+    std::atomic_int m_media { 0 };
+};
@@ -0,0 +1,198 @@
+// lifecyclemanager.cpp
+#include "lifecyclemanager.h"
+#include "logger.h"
+#include "trace.h"
+
+#include <QWebEngineView>
+#include <algorithm>
+
+namespace {
+
+    using LifecycleState = QWebEnginePage::LifecycleState;
+
+    QString stateName(LifecycleState state)
+    {
+        switch (state) {
+            case LifecycleState::Active:
+                return "Active";
+            case LifecycleState::Frozen:
+                return "Frozen";
+            case LifecycleState::Discarded:
+                return "Discarded";
+        }
+        return "Unknown";
+    }
+
+    // Active < Frozen < Discarded
+    int depth(LifecycleState state)
+    {
+        return static_cast<int>(state);
+    }
+
+}
+
+LifecycleManager::LifecycleManager(QWebEngineView *view, QObject *parent)
+: QObject(parent),
+m_view(view)
+{
+    m_freezeTimer.setSingleShot(true);
+    m_discardTimer.setSingleShot(true);
+
+    connect(&m_freezeTimer, &QTimer::timeout, this, [this] {
+        requestState(LifecycleState::Frozen);
+    });
+    connect(&m_discardTimer, &QTimer::timeout, this, [this] {
+        requestState(LifecycleState::Discarded);
+    });
+
+    watchPage();
+}
+
+void LifecycleManager::setDelays(int freezeDelaySec, int discardDelayMin)
+{
+    m_freezeDelaySec = std::max(0, freezeDelaySec);
+    m_discardDelayMin = std::max(0, discardDelayMin);
+}
+
+void LifecycleManager::sleep()
+{
+    watchPage();
+
+    if (!m_hiddenSince.isValid())
+        m_hiddenSince.start();
+
+    const qint64 elapsed = m_hiddenSince.elapsed();
+
+    const qint64 freezeIn = std::max<qint64>(0, m_freezeDelaySec * 1000LL - elapsed);
+    Logger::log(QString("Lifecycle: Freezing page in %1 s").arg(freezeIn / 1000));
+    m_freezeTimer.start(static_cast<int>(freezeIn));
+
+    if (m_discardDelayMin > 0) {
+        const qint64 discardIn = std::max<qint64>(freezeIn, m_discardDelayMin * 60000LL - elapsed);
+        Logger::log(QString("Lifecycle: Discarding page in %1 s").arg(discardIn / 1000));
+        m_discardTimer.start(static_cast<int>(discardIn));
+    } else {
+        m_discardTimer.stop();
+    }
+}
+
+void LifecycleManager::wake()
+{
+    watchPage();
+
+    m_freezeTimer.stop();
+    m_discardTimer.stop();
+    m_target = LifecycleState::Active;
+
+    QWebEnginePage *page = m_view ? m_view->page() : nullptr;
+    if (!page || page->lifecycleState() == LifecycleState::Active)
+        return;
+
+    Logger::log("Lifecycle: " + stateName(page->lifecycleState()) + " -> Active");
+    Trace::instant("lifecycle", "Active");
+    // Discarded pages reload themselves when made Active again.
+    page->setLifecycleState(LifecycleState::Active);
+}
+
+void LifecycleManager::endSession()
+{
+    m_hiddenSince.invalidate();
+}
+
+void LifecycleManager::freezeNow()
+{
+    m_freezeTimer.stop();
+    requestState(LifecycleState::Frozen);
+}
+
+void LifecycleManager::discardNow()
+{
+    m_freezeTimer.stop();
+    m_discardTimer.stop();
+    requestState(LifecycleState::Discarded);
+}
+
+QWebEnginePage::LifecycleState LifecycleManager::state() const
+{
+    QWebEnginePage *page = m_view ? m_view->page() : nullptr;
+    return page ? page->lifecycleState() : LifecycleState::Discarded;
+}
+
+void LifecycleManager::handleRecommendedStateChanged(QWebEnginePage::LifecycleState state)
+{
+    if (m_target == LifecycleState::Active)
+        return;
+
+    Logger::log("Lifecycle: Recommended state is now " + stateName(state));
+    applyTarget();
+}
+
+void LifecycleManager::setView(QWebEngineView *view)
+{
+    m_freezeTimer.stop();
+    m_discardTimer.stop();
+    m_target = QWebEnginePage::LifecycleState::Active;
+    m_view = view;
+    watchPage();
+}
+
+void LifecycleManager::watchPage()
+{
+    QWebEnginePage *page = m_view ? m_view->page() : nullptr;
+    if (page == m_watchedPage)
+        return;
+
+    if (m_watchedPage)
+        disconnect(m_watchedPage, nullptr, this, nullptr);
+
+    m_watchedPage = page;
+    if (!page)
+        return;
+
+    connect(page, &QWebEnginePage::recommendedStateChanged,
+            this, &LifecycleManager::handleRecommendedStateChanged);
+    connect(page, &QWebEnginePage::lifecycleStateChanged,
+            this, &LifecycleManager::stateChanged);
+    connect(page, &QObject::destroyed, this, [this, page] {
+        if (m_watchedPage == page)
+            m_watchedPage = nullptr;
+    });
+}
+
+void LifecycleManager::requestState(QWebEnginePage::LifecycleState target)
+{
+    watchPage();
+
+    if (depth(target) > depth(m_target))
+        m_target = target;
+
+    applyTarget();
+}
+
+void LifecycleManager::applyTarget()
+{
+    QWebEnginePage *page = m_view ? m_view->page() : nullptr;
+    if (!page)
+        return;
+
+    // Frozen/Discarded are not allowed while the page is on screen.
+    if (page->isVisible())
+        return;
+
+    // Never go deeper than Chromium considers safe (audio, calls, loading...).
+    const LifecycleState recommended = page->recommendedState();
+    LifecycleState next = m_target;
+    if (depth(recommended) < depth(next)) {
+        Logger::log("Lifecycle: " + stateName(m_target) + " deferred, recommended state is "
+                    + stateName(recommended));
+        next = recommended;
+    }
+
+    const LifecycleState current = page->lifecycleState();
+    if (depth(next) <= depth(current))
+        return;
+
+    Logger::log("Lifecycle: " + stateName(current) + " -> " + stateName(next));
+    Trace::instant("lifecycle", stateName(next));
+    page->setLifecycleState(next);
+}
@@ -0,0 +1,64 @@
+// lifecyclemanager.h
+#pragma once
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+#include <QWebEnginePage>
+
+class QWebEngineView;
+
+// Tiered sleep policy for the hidden page:
+// Active -> Frozen (after freezeDelay) -> Discarded (after discardDelay).
+// Delays are measured from the moment the window was hidden, so background
+// checks that briefly wake the page do not restart the clock.
+class LifecycleManager : public QObject
+{
+    Q_OBJECT
+public:
+    explicit LifecycleManager(QWebEngineView *view, QObject *parent = nullptr);
+
+    // The view is being replaced (deep sleep). nullptr stops all timers.
+    void setView(QWebEngineView *view);
+
+    // freezeDelay in seconds, discardDelay in minutes (0 = never discard)
+    void setDelays(int freezeDelaySec, int discardDelayMin);
+
+    // Page should not be running: arm the freeze/discard timers.
+    void sleep();
+    // Page must be running (shown, background check): cancel timers, go Active.
+    void wake();
+    // Window shown again: forget when the hidden period started.
+    void endSession();
+
+    // Immediate transitions, still gated by the page's recommended state.
+    void freezeNow();
+    void discardNow();
+
+    QWebEnginePage::LifecycleState state() const;
+
+signals:
+    void stateChanged(QWebEnginePage::LifecycleState state);
+
+private slots:
+    void handleRecommendedStateChanged(QWebEnginePage::LifecycleState state);
+
+private:
+    void watchPage();
+    void requestState(QWebEnginePage::LifecycleState target);
+    void applyTarget();
+
+    QWebEngineView *m_view;
+    QWebEnginePage *m_watchedPage = nullptr;
+
+    QTimer m_freezeTimer;
+    QTimer m_discardTimer;
+    QElapsedTimer m_hiddenSince;
+
+    int m_freezeDelaySec = 60;
+    int m_discardDelayMin = 30;
+
+    // Deepest state the policy wants; may be ahead of the page if
+    // recommendedState() does not allow it yet.
+    QWebEnginePage::LifecycleState m_target = QWebEnginePage::LifecycleState::Active;
+};
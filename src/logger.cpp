@@ -2,58 +2,555 @@
 #include "logger.h"
 
 #include <iostream>
-#include <QFile>
-#include <QTextStream>
 #include <QDateTime>
-#include <QStandardPaths>
 #include <QDir>
+#include <QFile>
+#include <QStandardPaths>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <mutex>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+    constexpr int SLOT_COUNT = 1024;     // power of two
+    constexpr int SLOT_TEXT = 496;       // bytes of UTF-8 per line; longer lines are cut
+    constexpr int BATCH_DELAY_MS = 20;   // let a burst collect before writing it out
+    constexpr qsizetype BATCH_LIMIT = 64 * 1024;
+    // Slots stay taken until their batch is written: leave most of the
+    // ring to the producers meanwhile
+    constexpr quint64 BATCH_SLOTS = SLOT_COUNT / 4;
+
+    // Bounded MPMC queue (Vyukov): a slot is free for position p when its
+    // sequence is p, and holds a line for p when it is p + 1
+    struct Slot {
+        std::atomic<quint64> sequence;
+        qint64 msecs;
+        quint8 level;
+        quint16 length;
+        char text[SLOT_TEXT];
+    };
+
+    Slot s_slots[SLOT_COUNT];
+    std::atomic<quint64> s_head { 0 }; // next position to fill
+    std::atomic<quint64> s_tail { 0 }; // next position to drain
+    std::atomic<quint32> s_dropped { 0 };
+
+    std::atomic_bool s_fileEnabled { false };
+    std::atomic<qint64> s_maxBytes { 1024 * 1024 };
+    std::atomic<int> s_maxFiles { 3 };
+
+    std::once_flag s_startOnce;
+    std::thread *s_writer = nullptr;
+    std::mutex s_wakeMutex;
+    std::condition_variable s_wake;    // the writer sleeps here when idle
+    std::condition_variable s_flushed; // flush() waits here
+    std::atomic_bool s_writerIdle { false };
+    bool s_stopping = false;           // guarded by s_wakeMutex
+    quint64 s_flushRequested = 0;      // guarded by s_wakeMutex
+    quint64 s_flushServed = 0;         // guarded by s_wakeMutex
+    std::atomic_bool s_stopped { false };
+
+    // Owned by the writer thread; the crash handler only reads them
+    std::atomic<int> s_fd { -1 };
+    qint64 s_fileSize = 0;
+    std::atomic<qint64> s_stampSecond { -1 };
+    char s_stamp[32];
+    int s_stampLength = 0;
+
+    const char *levelTag(quint8 level)
+    {
+        switch (Logger::Level(level)) {
+            case Logger::Level::Debug:   return "debug: ";
+            case Logger::Level::Warning: return "warning: ";
+            case Logger::Level::Error:   return "error: ";
+            default:                     return "";
+        }
+    }
+
+    QString logDir()
+    {
+        return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/whatsit";
+    }
+
+    QString logPath()
+    {
+        return logDir() + "/whatsit.log";
+    }
+
+    void writeAll(int fd, const char *data, qsizetype size)
+    {
+        while (size > 0) {
+            const ssize_t n = ::write(fd, data, size_t(size));
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0)
+                return;
+            data += n;
+            size -= n;
+        }
+    }
+
+    // ---------------- Queue ----------------
+
+    bool enqueue(Logger::Level level, const QByteArray &utf8)
+    {
+        quint64 pos = s_head.load(std::memory_order_relaxed);
+        Slot *slot;
+        for (;;) {
+            slot = &s_slots[pos & (SLOT_COUNT - 1)];
+            const qint64 diff = qint64(slot->sequence.load(std::memory_order_acquire)) - qint64(pos);
+            if (diff == 0) {
+                if (s_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false; // full
+            } else {
+                pos = s_head.load(std::memory_order_relaxed);
+            }
+        }
+
+        int length = int(qMin<qsizetype>(utf8.size(), SLOT_TEXT));
+        // Do not cut a multi-byte character in half
+        if (length < utf8.size())
+            while (length > 0 && (uchar(utf8.at(length)) & 0xc0) == 0x80)
+                --length;
+
+        slot->msecs = QDateTime::currentMSecsSinceEpoch();
+        slot->level = quint8(level);
+        slot->length = quint16(length);
+        std::memcpy(slot->text, utf8.constData(), size_t(length));
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Hands the oldest line to fn and frees its slot. Lock-free, so the
+    // crash handler can drain while the writer thread is stopped anywhere.
+    template <typename Fn>
+    bool consume(Fn &&fn)
+    {
+        quint64 pos = s_tail.load(std::memory_order_relaxed);
+        Slot *slot;
+        for (;;) {
+            slot = &s_slots[pos & (SLOT_COUNT - 1)];
+            const qint64 diff = qint64(slot->sequence.load(std::memory_order_acquire)) - qint64(pos + 1);
+            if (diff == 0) {
+                if (s_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false; // empty, or the next line is still being filled
+            } else {
+                pos = s_tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        fn(*slot);
+        slot->sequence.store(pos + SLOT_COUNT, std::memory_order_release);
+        return true;
+    }
+
+    // Frees [from, to) once the writer has written them out. Until then
+    // s_tail still points at them, so a crash mid-batch writes them again
+    // rather than losing them; if the crash handler already took some,
+    // it frees those itself.
+    void release(quint64 from, quint64 to)
+    {
+        if (!s_tail.compare_exchange_strong(from, to, std::memory_order_relaxed))
+            return;
+        for (quint64 pos = from; pos < to; ++pos)
+            s_slots[pos & (SLOT_COUNT - 1)].sequence.store(pos + SLOT_COUNT, std::memory_order_release);
+    }
+
+    bool hasPending()
+    {
+        const quint64 pos = s_tail.load(std::memory_order_relaxed);
+        return s_slots[pos & (SLOT_COUNT - 1)].sequence.load(std::memory_order_acquire) == pos + 1;
+    }
+
+    // ---------------- Writer ----------------
+
+    // Formatting a QDateTime costs far more than the rest of a line,
+    // and a burst of lines shares the same second
+    void appendStamp(QByteArray &out, qint64 msecs)
+    {
+        const qint64 second = msecs / 1000;
+        if (second != s_stampSecond.load(std::memory_order_relaxed)) {
+            const QByteArray stamp = "[" + QDateTime::fromMSecsSinceEpoch(second * 1000)
+                .toString("dd-MM-yyyy HH:mm:ss").toLatin1() + "] ";
+            s_stampLength = int(qMin<qsizetype>(stamp.size(), sizeof(s_stamp)));
+            std::memcpy(s_stamp, stamp.constData(), size_t(s_stampLength));
+            s_stampSecond.store(second, std::memory_order_release);
+        }
+        out.append(s_stamp, s_stampLength);
+    }
+
+    void appendLine(QByteArray &out, const Slot &slot)
+    {
+        appendStamp(out, slot.msecs);
+        out += levelTag(slot.level);
+        out.append(slot.text, slot.length);
+        out += '\n';
+    }
+
+    void closeFile()
+    {
+        const int fd = s_fd.exchange(-1);
+        if (fd >= 0)
+            ::close(fd);
+    }
+
+    void openFile()
+    {
+        QDir().mkpath(logDir());
+        const int fd = ::open(QFile::encodeName(logPath()).constData(),
+                              O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        struct stat st;
+        s_fileSize = fd >= 0 && ::fstat(fd, &st) == 0 ? st.st_size : 0;
+        s_fd = fd;
+    }
+
+    // whatsit.log -> .1 -> .2 ...; the oldest beyond maxFiles goes
+    void rotate()
+    {
+        closeFile();
+        const QString path = logPath();
+        const int files = s_maxFiles.load();
+        if (files <= 1) {
+            QFile::remove(path);
+        } else {
+            QFile::remove(path + "." + QString::number(files - 1));
+            for (int i = files - 2; i >= 1; --i)
+                QFile::rename(path + "." + QString::number(i), path + "." + QString::number(i + 1));
+            QFile::rename(path, path + ".1");
+        }
+        openFile();
+    }
+
+    void writeBatch(const QByteArray &batch)
+    {
+        if (!batch.isEmpty())
+            writeAll(STDOUT_FILENO, batch.constData(), batch.size());
+
+        if (!s_fileEnabled.load()) {
+            closeFile();
+            return;
+        }
+        if (s_fd < 0)
+            openFile();
+        if (s_fd < 0 || batch.isEmpty())
+            return;
+
+        writeAll(s_fd, batch.constData(), batch.size());
+        s_fileSize += batch.size();
+        const qint64 maxBytes = s_maxBytes.load();
+        if (maxBytes > 0 && s_fileSize >= maxBytes)
+            rotate();
+    }
+
+    void drain(QByteArray &batch)
+    {
+        batch.clear();
+        const quint32 dropped = s_dropped.exchange(0);
+        if (dropped > 0) {
+            appendStamp(batch, QDateTime::currentMSecsSinceEpoch());
+            batch += "warning: Logger: Queue full, " + QByteArray::number(dropped) + " lines dropped\n";
+        }
+
+        // Only this thread advances s_tail outside a crash
+        for (;;) {
+            const quint64 from = s_tail.load(std::memory_order_relaxed);
+            quint64 to = from;
+            while (to - from < BATCH_SLOTS && batch.size() < BATCH_LIMIT) {
+                const Slot &slot = s_slots[to & (SLOT_COUNT - 1)];
+                if (slot.sequence.load(std::memory_order_acquire) != to + 1)
+                    break;
+                appendLine(batch, slot);
+                ++to;
+            }
+            writeBatch(batch);
+            batch.clear();
+            if (to == from)
+                return;
+            release(from, to);
+        }
+    }
+
+    void writerLoop()
+    {
+        QByteArray batch;
+        batch.reserve(BATCH_LIMIT);
+
+        for (;;) {
+            quint64 request;
+            bool stopping;
+            {
+                std::unique_lock<std::mutex> lock(s_wakeMutex);
+                s_writerIdle = true;
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                s_wake.wait(lock, [] {
+                    return !s_writerIdle || hasPending() || s_stopping || s_flushServed < s_flushRequested;
+                });
+                s_writerIdle = false;
+
+                // Nobody is waiting: let the rest of a burst arrive first
+                if (!s_stopping && s_flushServed == s_flushRequested) {
+                    s_wake.wait_for(lock, std::chrono::milliseconds(BATCH_DELAY_MS), [] {
+                        return s_stopping || s_flushServed < s_flushRequested;
+                    });
+                }
+                request = s_flushRequested;
+                stopping = s_stopping;
+            }
 
-bool Logger::s_fileLoggingEnabled = false;
+            drain(batch);
+
+            {
+                std::lock_guard<std::mutex> lock(s_wakeMutex);
+                s_flushServed = request;
+            }
+            s_flushed.notify_all();
+
+            if (stopping) {
+                closeFile();
+                return;
+            }
+        }
+    }
+
+    void wakeWriter()
+    {
+        // Pairs with the fence in writerLoop: either the writer sees the
+        // new line, or we see it idle and wake it
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (s_writerIdle.load(std::memory_order_relaxed) && s_writerIdle.exchange(false)) {
+            std::lock_guard<std::mutex> lock(s_wakeMutex);
+            s_wake.notify_one();
+        }
+    }
+
+    void stopWriter()
+    {
+        {
+            std::lock_guard<std::mutex> lock(s_wakeMutex);
+            s_stopping = true;
+        }
+        s_wake.notify_one();
+        s_writer->join();
+        s_stopped = true;
+    }
+
+    void start()
+    {
+        for (int i = 0; i < SLOT_COUNT; ++i)
+            s_slots[i].sequence.store(quint64(i), std::memory_order_relaxed);
+        s_writer = new std::thread(writerLoop);
+        // Runs after main() returns, before static destructors
+        std::atexit(stopWriter);
+    }
+
+    // ---------------- Crash path ----------------
+
+    // Only async-signal-safe calls from here on: no allocation, no Qt
+    void crashWriteNumber(int fd, qint64 value)
+    {
+        char digits[24];
+        int i = sizeof(digits);
+        do {
+            digits[--i] = char('0' + value % 10);
+            value /= 10;
+        } while (value > 0 && i > 0);
+        writeAll(fd, digits + i, sizeof(digits) - i);
+    }
+
+    void crashWriteSlot(int fd, const Slot &slot)
+    {
+        // The writer's cached stamp, if it is for the same second;
+        // otherwise a raw epoch time rather than a wrong one
+        if (slot.msecs / 1000 == s_stampSecond.load(std::memory_order_acquire)) {
+            writeAll(fd, s_stamp, s_stampLength);
+        } else {
+            writeAll(fd, "[@", 2);
+            crashWriteNumber(fd, slot.msecs);
+            writeAll(fd, "] ", 2);
+        }
+        const char *tag = levelTag(slot.level);
+        writeAll(fd, tag, qsizetype(std::strlen(tag)));
+        writeAll(fd, slot.text, slot.length);
+        writeAll(fd, "\n", 1);
+    }
+
+    void crashHandler(int sig)
+    {
+        const int fd = s_fd.load();
+        while (consume([fd](const Slot &slot) {
+            crashWriteSlot(STDOUT_FILENO, slot);
+            if (fd >= 0)
+                crashWriteSlot(fd, slot);
+        })) {}
+
+        const char note[] = "Logger: Fatal signal ";
+        for (int out : { int(STDOUT_FILENO), fd }) {
+            if (out < 0)
+                continue;
+            writeAll(out, note, sizeof(note) - 1);
+            crashWriteNumber(out, sig);
+            writeAll(out, "\n", 1);
+        }
+
+        // SA_RESETHAND restored the default action
+        ::raise(sig);
+    }
+
+}
 
 void Logger::log(const QString &message)
 {
-    QString timestamp = QDateTime::currentDateTime().toString("dd-MM-yyyy HH:mm:ss");
-    QString logMsg = QString("[%1] %2").arg(timestamp, message);
+    log(Level::Info, message);
+}
 
-    std::cout << logMsg.toStdString() << std::endl;
+void Logger::log(Level level, const QString &message)
+{
+    if (int(level) < s_level.load(std::memory_order_relaxed))
+        return;
 
-    if (s_fileLoggingEnabled) {
-        QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/whatsit";
-        QDir().mkpath(cacheDir);
-        QString logPath = cacheDir + "/whatsit.log";
+    std::call_once(s_startOnce, start);
+    const QByteArray utf8 = message.toUtf8();
 
-        QFile file(logPath);
-        if (file.open(QIODevice::Append | QIODevice::Text)) {
-            QTextStream out(&file);
-            out << logMsg << "\n";
-            file.close();
-        }
+    // Static destructors may still log after the writer has gone
+    if (s_stopped.load(std::memory_order_relaxed)) {
+        QByteArray line;
+        appendStamp(line, QDateTime::currentMSecsSinceEpoch());
+        line += levelTag(quint8(level)) + utf8 + '\n';
+        writeAll(STDOUT_FILENO, line.constData(), line.size());
+        return;
+    }
+
+    // Never block the caller: a full queue means the disk cannot keep up
+    if (!enqueue(level, utf8))
+        s_dropped.fetch_add(1, std::memory_order_relaxed);
+    wakeWriter();
+}
+
+void Logger::setLevel(Level level)
+{
+    s_level = int(level);
+}
+
+Logger::Level Logger::level()
+{
+    return Level(s_level.load());
+}
+
+void Logger::setCategories(quint32 mask)
+{
+    s_categories = mask;
+}
+
+Logger::Level Logger::parseLevel(const QString &name, Level fallback)
+{
+    const QString key = name.trimmed().toLower();
+    if (key == "debug")
+        return Level::Debug;
+    if (key == "info")
+        return Level::Info;
+    if (key == "warning")
+        return Level::Warning;
+    if (key == "error")
+        return Level::Error;
+    return fallback;
+}
+
+quint32 Logger::parseCategories(const QString &names)
+{
+    static const QList<QPair<QString, Category>> known = {
+        { "general", Category::General },
+        { "web", Category::Web },
+        { "console", Category::Console },
+        { "notify", Category::Notify },
+        { "ipc", Category::Ipc },
+        { "memory", Category::Memory },
+    };
+
+    quint32 mask = 0;
+    for (const QString &part : names.split(',', Qt::SkipEmptyParts)) {
+        const QString name = part.trimmed().toLower();
+        if (name == "all")
+            return AllCategories;
+        for (const auto &entry : known)
+            if (entry.first == name)
+                mask |= quint32(entry.second);
     }
+    // Unknown names only: better everything than silence
+    return mask ? mask : AllCategories;
 }
 
 void Logger::setFileLoggingEnabled(bool enabled)
 {
-    s_fileLoggingEnabled = enabled;
+    s_fileEnabled = enabled;
 }
 
 bool Logger::isFileLoggingEnabled()
 {
-    return s_fileLoggingEnabled;
+    return s_fileEnabled;
+}
+
+void Logger::setRotation(qint64 maxBytes, int maxFiles)
+{
+    s_maxBytes = maxBytes;
+    s_maxFiles = qMax(1, maxFiles);
+}
+
+void Logger::flush()
+{
+    std::call_once(s_startOnce, start);
+    if (s_stopped)
+        return;
+
+    std::unique_lock<std::mutex> lock(s_wakeMutex);
+    const quint64 request = ++s_flushRequested;
+    s_wake.notify_one();
+    s_flushed.wait_for(lock, std::chrono::seconds(2), [request] { return s_flushServed >= request; });
+}
+
+void Logger::installCrashHandler()
+{
+    std::call_once(s_startOnce, start);
+
+    struct sigaction action {};
+    action.sa_handler = crashHandler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESETHAND;
+
+    for (int sig : { SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT, SIGTERM, SIGINT }) {
+        struct sigaction previous {};
+        // Leave handlers someone else installed alone
+        if (::sigaction(sig, nullptr, &previous) == 0 && previous.sa_handler == SIG_DFL)
+            ::sigaction(sig, &action, nullptr);
+    }
 }
 
 void Logger::deleteLogFile()
 {
-    QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/whatsit";
-    QString logPath = cacheDir + "/whatsit.log";
-    
-    QFile file(logPath);
-    if (file.exists()) {
-        std::cout << "Deleting log file: " << logPath.toStdString() << std::endl;
-        if (file.remove()) {
+    // With file logging off, the writer closes the file on its next pass
+    flush();
+
+    QDir dir(logDir());
+    const QStringList files = dir.entryList({ "whatsit.log", "whatsit.log.*" }, QDir::Files);
+    for (const QString &name : files) {
+        const QString path = dir.filePath(name);
+        std::cout << "Deleting log file: " << path.toStdString() << std::endl;
+        if (QFile::remove(path)) {
              std::cout << "Log file deleted successfully." << std::endl;
         } else {
              std::cout << "Failed to delete log file." << std::endl;
         }
     }
 }
-
@@ -2,14 +2,76 @@
 #pragma once
 
 #include <QString>
+#include <atomic>
 
+// Levels below this are compiled out of WHATSIT_LOG, arguments and all:
+// 0 debug, 1 info, 2 warning, 3 error, 4 nothing. Set by CMake.
+#ifndef WHATSIT_MIN_LOG_LEVEL
+#define WHATSIT_MIN_LOG_LEVEL 0
+#endif
+
+// Lines are queued into a fixed ring and written by a background thread,
+// so logging never blocks on the terminal or the disk. The queue is
+// drained on exit, by flush(), and on a fatal signal. A line leaves the
+// ring only once written, so a crash during a write may repeat lines but
+// does not lose them.
 class Logger {
 public:
+    enum class Level { Debug, Info, Warning, Error };
+
+    // Bit flags, selected at runtime by setCategories()
+    enum class Category : quint32 {
+        General = 1 << 0,
+        Web     = 1 << 1, // page, permissions, downloads
+        Console = 1 << 2, // JavaScript console
+        Notify  = 1 << 3,
+        Ipc     = 1 << 4,
+        Memory  = 1 << 5,
+    };
+    static constexpr quint32 AllCategories = 0xffffffffu;
+
     static void log(const QString &message);
+    static void log(Level level, const QString &message);
+
+    // Cheap enough for hot paths; WHATSIT_LOG checks it before
+    // building the message
+    static bool isEnabled(Level level, Category category)
+    {
+        return int(level) >= s_level.load(std::memory_order_relaxed)
+            && (s_categories.load(std::memory_order_relaxed) & quint32(category));
+    }
+
+    static void setLevel(Level level); // lines below it are dropped
+    static Level level();
+    static void setCategories(quint32 mask);
+    // "debug", "info", "warning" or "error"
+    static Level parseLevel(const QString &name, Level fallback);
+    // Comma separated category names, or "all"
+    static quint32 parseCategories(const QString &names);
+
     static void setFileLoggingEnabled(bool enabled);
     static bool isFileLoggingEnabled();
+    // whatsit.log is rotated to whatsit.log.1 .. .N-1 when it reaches maxBytes
+    static void setRotation(qint64 maxBytes, int maxFiles);
     static void deleteLogFile();
 
+    // Blocks until everything logged so far has been written
+    static void flush();
+    // Write out queued lines on SIGSEGV, SIGABRT etc. before dying
+    static void installCrashHandler();
+
 private:
-    static bool s_fileLoggingEnabled;
+    static inline std::atomic<int> s_level { int(Level::Info) };
+    static inline std::atomic<quint32> s_categories { AllCategories };
 };
+
+// WHATSIT_LOG(Debug, Console, QString("...").arg(...)): the message is only
+// built when the level and category are enabled, and not compiled at all
+// below WHATSIT_MIN_LOG_LEVEL. Use it wherever formatting is not free.
+#define WHATSIT_LOG(level, category, message)                                            \
+    do {                                                                                 \
+        if constexpr (int(Logger::Level::level) >= WHATSIT_MIN_LOG_LEVEL) {              \
+            if (Logger::isEnabled(Logger::Level::level, Logger::Category::category))     \
+                Logger::log(Logger::Level::level, message);                              \
+        }                                                                                \
+    } while (false)
@@ -1,28 +1,59 @@
 // main.cpp
 #include "configmanager.h"
+#include "engineprofile.h"
 #include "ipcmanager.h"
+#include "latencyrecorder.h"
 #include "logger.h"
 #include "mainwindow.h"
+#include "trace.h"
 #include <QApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QProcess>
+#include <cstring>
 #include <iostream>
 
 int main(int argc, char *argv[]) {
+    LatencyRecorder::processStarted();
+
+    // Dump collected latencies without starting a GUI
+    if (argc == 2 && std::strcmp(argv[1], "latency") == 0) {
+        QCoreApplication::setOrganizationName("whatsit");
+        QCoreApplication::setApplicationName("whatsit");
+        return LatencyRecorder::dump(std::cout);
+    }
+
+    Logger::installCrashHandler();
     Logger::log("Application starting...");
 
-    QApplication app(argc, argv);
-    app.setApplicationName("whatsit");
-    app.setOrganizationName("whatsit");
-    app.setDesktopFileName("whatsit");
+    // Parsed from argv: a link click handed to a running instance must not
+    // pay for QApplication (platform plugin, display connection) first
+    QStringList args;
+    for (int i = 0; i < argc; ++i)
+        args << QString::fromLocal8Bit(argv[i]);
 
-    QStringList args = app.arguments();
     bool showFlag = false;
     bool hideFlag = false;
     bool helpFlag = false;
+    bool checkFlag = false;
+    bool prewarmFlag = false;
+    bool managed = false;
     int flagCount = 0;
+    QString url;
 
     for (int i = 1; i < args.size(); ++i) {
         const QString &arg = args[i];
-        if (arg == "show") {
+        if (arg == "--managed") {
+            // Started by whatsit-tray; see TrayStub
+            managed = true;
+        } else if (arg == "check") {
+            checkFlag = true;
+            flagCount++;
+        } else if (arg == "prewarm") {
+            prewarmFlag = true;
+            flagCount++;
+        } else if (arg == "show") {
             showFlag = true;
             flagCount++;
         } else if (arg == "hide") {
@@ -31,9 +62,16 @@ int main(int argc, char *argv[]) {
         } else if (arg == "help" || arg == "--help" || arg == "-h") {
             helpFlag = true;
             flagCount++;
+        } else if (url.isEmpty() && (arg.startsWith("http") || arg.startsWith("whatsapp"))) {
+            url = arg;
         }
     }
 
+    if ((checkFlag || prewarmFlag) && !managed) {
+        std::cerr << "Error: 'check' and 'prewarm' are only used by whatsit-tray." << std::endl;
+        return 1;
+    }
+
     if (flagCount > 1) {
         std::cerr << "Error: Only one of 'show', 'hide', or 'help' flags can be passed." << std::endl;
         std::cout << "Usage: whatsit [show|hide|help] [url]" << std::endl;
@@ -46,28 +84,78 @@ int main(int argc, char *argv[]) {
         std::cout << "  show    Start the application with the window visible." << std::endl;
         std::cout << "  hide    Start the application minimized to the tray." << std::endl;
         std::cout << "  help    Show this help message." << std::endl;
+        std::cout << "  latency Print startup and show latency percentiles, then exit." << std::endl;
         std::cout << std::endl;
         std::cout << "Arguments:" << std::endl;
         std::cout << "  url     Optional URL to open (starts with http, https, or whatsapp)." << std::endl;
         return 0;
     }
 
-    // Single-instance check
-    QString ipcCommand = "raise";
-    if (hideFlag) {
-        ipcCommand = "hide";
-    }
-    
-    if (IpcManager::notifyExistingInstance(ipcCommand)) {
+    // Single-instance check. A managed UI process is the stub's child and
+    // must not talk to it as if it were another instance.
+    const QString ipcCommand = hideFlag ? "hide" : "raise";
+    if (!managed && IpcManager::notifyExistingInstance(ipcCommand, url)) {
         return 0;
     }
 
+    // Chromium switches are read once when WebEngine starts,
+    // so the engine profile has to be exported before QApplication exists.
+    // The constructor has already upgraded an old whatsit.ini.
     ConfigManager config;
+
+    // Split-process mode: hand over to the resident tray stub, which
+    // starts us again with --managed when the window is needed. Before the
+    // engine flags are exported (the stub would pass them on) and before
+    // any GUI exists. No QCoreApplication yet for applicationDirPath().
+    if (!managed && config.splitProcess()) {
+        const QString stub = QFileInfo(QFile::symLinkTarget("/proc/self/exe")).absolutePath() + "/whatsit-tray";
+        if (QProcess::startDetached(stub, args.mid(1))) {
+            Logger::log("Split-process mode: Started whatsit-tray, exiting.");
+            return 0;
+        }
+        Logger::log("Split-process mode: Could not start " + stub + ", running standalone.");
+    }
+
+    EngineProfile::apply(config);
+
+    QElapsedTimer phase;
+    phase.start();
+    QApplication app(argc, argv);
+    LatencyRecorder::record("startup.qapplication", phase.elapsed());
+    app.setApplicationName("whatsit");
+    app.setOrganizationName("whatsit");
+    app.setDesktopFileName("whatsit");
+
+    phase.start();
     config.load();
+    LatencyRecorder::record("startup.config-load", phase.elapsed());
+    LatencyRecorder::setContext(LatencyRecorder::defaultContext(config.engineProfile()));
+    QObject::connect(&app, &QCoreApplication::aboutToQuit, [] { LatencyRecorder::save(); });
+    QObject::connect(&app, &QCoreApplication::aboutToQuit, &config, &ConfigManager::sync);
+
+    // WHATSIT_TRACE=<file> traces a single run without touching the config;
+    // every UI the tray stub launches inherits it, hence the per-process name
+    const QString tracePath = qEnvironmentVariable("WHATSIT_TRACE");
+    if (!tracePath.isEmpty())
+        Trace::start(Trace::processPath(tracePath, "ui"));
+    else if (config.tracingEnabled())
+        Trace::start(Trace::defaultPath());
+    QObject::connect(&app, &QCoreApplication::aboutToQuit, [] { Trace::stop(); });
 
-    MainWindow w(config); // pass config to MainWindow
+    MainWindow w(config, managed); // pass config to MainWindow
+
+    if (checkFlag) {
+        w.runBackgroundCheck();
+        return app.exec();
+    }
+    if (prewarmFlag) {
+        w.prewarm("stub");
+        return app.exec();
+    }
     
     bool startMinimized = config.startMinimizedInTray();
+    if (managed)
+        startMinimized = !showFlag;
     
     if (showFlag) {
         startMinimized = false;
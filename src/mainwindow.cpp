@@ -1,19 +1,31 @@
 // mainwindow.cpp
 #include "mainwindow.h"
 
+#include "engineprofile.h"
 #include "ipcmanager.h"
+#include "latencyrecorder.h"
+#include "lifecyclemanager.h"
 #include "logger.h"
+#include "memorysampler.h"
+#include "psimonitor.h"
+#include "readinessprobe.h"
+#include "snapshotoverlay.h"
+#include "trace.h"
 #include "traymanager.h"
 #include "webenginehelper.h"
 #include <KIconDialog>
 #include <KIconLoader>
 #include <KNotification>
+#include <QActionGroup>
 #include <QCheckBox>
 #include <QCloseEvent>
 #include <QColor>
+#include <QComboBox>
 #include <QDialog>
 #include <QDir>
+#include <QFile>
 #include <QFormLayout>
+#include <QInputDialog>
 #include <QLabel>
 #include <QLineEdit>
 #include <QMenuBar>
@@ -27,59 +39,64 @@
 #include <QUrl>
 #include <QUrlQuery>
 #include <QVBoxLayout>
+#include <QWebEnginePage>
 #include <QWebEngineView>
 #include <cmath>
-#include <unistd.h>
 
 static constexpr int DEFAULT_W = 1200;
 static constexpr int DEFAULT_H = 800;
+// A cold show gives up on readiness (and the snapshot) after this
+static constexpr int SHOW_READY_TIMEOUT_MS = 30000;
+// PSI fires every 2 s while pressure lasts: a frozen page gets this long
+// to relieve it before the next event discards it
+static constexpr int PRESSURE_STEP_COOLDOWN_MS = 30000;
 // <html><body style="background-color: #1e1e1e;"></body></html>
 static const QUrl DARK_BLANK_URL("data:text/html;base64,PGh0bWw+PGJvZHkgc3R5bGU9ImJhY2tncm91bmQtY29sb3I6ICMxZTFlMWU7Ij48L2JvZHk+PC9odG1sPg==");
 
-MainWindow::MainWindow(ConfigManager& config, QWidget* parent)
+MainWindow::MainWindow(ConfigManager& config, bool managed, QWidget* parent)
     : QMainWindow(parent)
     , config(config)
-    , view(new QWebEngineView(this))
+    , view(nullptr)
     , web(nullptr)
     , tray(nullptr)
     , ipc(nullptr)
+    , lifecycle(nullptr)
+    , memorySampler(nullptr)
+    , memoryLadder(nullptr)
+    , psiMonitor(nullptr)
+    , readinessProbe(nullptr)
+    , snapshotOverlay(nullptr)
     , periodicCheckTimer(this)
     , activeCheckTimer(this)
+    , deepSleepTimer(this)
+    , idleExitTimer(this)
+    , prewarmTimer(this)
+    , predictTimer(this)
+    , m_managed(managed)
 {
     Logger::log("MainWindow constructor");
     // Prevent Qt from quitting when last window is hidden
     qApp->setQuitOnLastWindowClosed(false);
 
-    setCentralWidget(view);
-
+    Logger::setRotation(config.logMaxSizeKb() * 1024LL, config.logMaxFiles());
     Logger::setFileLoggingEnabled(config.debugLoggingEnabled());
+    Logger::setLevel(Logger::parseLevel(config.logLevel(),
+        config.debugLoggingEnabled() ? Logger::Level::Debug : Logger::Level::Info));
+    Logger::setCategories(Logger::parseCategories(config.logCategories()));
 
     if (config.rememberWindowSize())
         resize(config.windowSize());
     else
         resize(DEFAULT_W, DEFAULT_H);
 
-    web = new WebEngineHelper(view, &config, this);
-    web->initialize();
-
-    // comment by: devlinman
-    // Set background color to dark to prevent flashbangs
-    if (view->page()) {
-        view->page()->setBackgroundColor(QColor("#1e1e1e"));
+    // In managed mode the tray icon belongs to the stub process
+    if (!m_managed) {
+        tray = new TrayManager(this);
+        tray->initialize();
+        tray->setIndicatorEnabled(config.showTrayIndicator());
+        tray->setTooltipEnabled(config.showTrayTooltip());
     }
 
-    // Set initial zoom level
-    view->setZoomFactor(config.zoomLevel());
-
-    tray = new TrayManager(this);
-    tray->initialize();
-    tray->setIndicatorEnabled(config.showTrayIndicator());
-    tray->setTooltipEnabled(config.showTrayTooltip());
-
-    connect(web, &WebEngineHelper::notificationReceived, this, &MainWindow::handleMessageDetected);
-    connect(web, &WebEngineHelper::unreadChanged, this, &MainWindow::handleUnreadChanged);
-    connect(web, &WebEngineHelper::activationRequested, this, &MainWindow::showAndRaise);
-
     QString trayIconToUse = "whatsit";
     QString appIconToUse = "whatsit";
 
@@ -119,24 +136,52 @@ MainWindow::MainWindow(ConfigManager& config, QWidget* parent)
         return;
     }
 
-    tray->setIcon(trayIconToUse);
+    if (tray) {
+        tray->setIcon(trayIconToUse);
 
-    connect(tray, &TrayManager::showRequested, this, &MainWindow::showAndRaise);
-    connect(tray, &TrayManager::hideRequested, this, &QWidget::hide);
-    connect(tray, &TrayManager::activated, this, [this] {
-        if (isVisible() && isActiveWindow() && !isMinimized()) {
-            hide();
-        } else {
-            showAndRaise();
-        }
-    });
+        connect(tray, &TrayManager::showRequested, this, &MainWindow::showAndRaise);
+        connect(tray, &TrayManager::hideRequested, this, &MainWindow::hideToTray);
+        connect(tray, &TrayManager::activated, this, &MainWindow::toggleVisibility);
+        connect(tray, &TrayManager::intentDetected, this, &MainWindow::prewarm);
+    }
 
     ipc = new IpcManager(this);
     connect(ipc, &IpcManager::raiseRequested, this, &MainWindow::showAndRaise);
-    connect(ipc, &IpcManager::hideRequested, this, &MainWindow::hide);
+    connect(ipc, &IpcManager::hideRequested, this, &MainWindow::hideToTray);
     connect(ipc, &IpcManager::openUrlRequested, this,
         &MainWindow::handleIncomingUrl);
-    ipc->start();
+    connect(ipc, &IpcManager::toggleRequested, this, &MainWindow::toggleVisibility);
+    connect(ipc, &IpcManager::checkRequested, this, &MainWindow::runBackgroundCheck);
+    connect(ipc, &IpcManager::prewarmRequested, this, [this] { prewarm("stub"); });
+    ipc->start(m_managed ? IpcManager::UiServer : IpcManager::MainServer);
+
+    // Managed mode: nothing left to do once hidden for a while, the stub
+    // starts us again when needed
+    idleExitTimer.setSingleShot(true);
+    connect(&idleExitTimer, &QTimer::timeout, this, &MainWindow::handleIdleExit);
+
+    prewarmTimer.setSingleShot(true);
+    connect(&prewarmTimer, &QTimer::timeout, this, &MainWindow::cancelPrewarm);
+
+    const QString dataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QDir().mkpath(dataPath);
+    usagePredictor.load(dataPath + "/usage-pattern.bin");
+    predictTimer.setSingleShot(true);
+    connect(&predictTimer, &QTimer::timeout, this, &MainWindow::handlePredictedShow);
+
+    snapshotOverlay = new SnapshotOverlay(this);
+    snapshotOverlay->setMaxBytes(config.snapshotMaxSize() * 1024LL);
+    if (config.snapshotOnDisk())
+        snapshotOverlay->setCacheFile(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/last-frame.jpg");
+
+    memorySampler = new MemorySampler(this);
+    connect(memorySampler, &MemorySampler::snapshotReady, this, &MainWindow::handleMemorySnapshot);
+
+    memoryLadder = new MemoryLadder(this);
+    if (!config.memoryLadder().isEmpty())
+        memoryLadder->setSteps(config.memoryLadder());
+    memoryLadder->setHysteresis(config.memoryLadderHysteresis());
+    connect(memoryLadder, &MemoryLadder::stepTriggered, this, &MainWindow::handleMemoryLadderStep);
 
     memoryTimer = new QTimer(this);
     connect(memoryTimer, &QTimer::timeout, this, &MainWindow::checkMemoryUsage);
@@ -144,10 +189,22 @@ MainWindow::MainWindow(ConfigManager& config, QWidget* parent)
         memoryTimer->start(30000); // Check every 30 seconds
     }
 
+    psiMonitor = new PsiMonitor(this);
+    connect(psiMonitor, &PsiMonitor::pressureDetected, this, &MainWindow::handleSystemPressure);
+    if (config.reactToSystemPressure()) {
+        psiMonitor->start();
+    }
+
+    periodicCheckTimer.setSingleShot(true);
     connect(&periodicCheckTimer, &QTimer::timeout, this, &MainWindow::startPeriodicCheck);
 
     activeCheckTimer.setSingleShot(true);
-    connect(&activeCheckTimer, &QTimer::timeout, this, &MainWindow::finishPeriodicCheck);
+    connect(&activeCheckTimer, &QTimer::timeout, this, [this] {
+        finishPeriodicCheck("timeout");
+    });
+
+    deepSleepTimer.setSingleShot(true);
+    connect(&deepSleepTimer, &QTimer::timeout, this, &MainWindow::enterDeepSleep);
 
     auto* quitShortcut = new QShortcut(QKeySequence::Quit, this);
     quitShortcut->setContext(Qt::ApplicationShortcut);
@@ -158,24 +215,32 @@ MainWindow::MainWindow(ConfigManager& config, QWidget* parent)
     fullQuitShortcut->setContext(Qt::ApplicationShortcut);
     connect(fullQuitShortcut, &QShortcut::activated, this, [this] {
         Logger::log("Ctrl+Shift+Q pressed -> Force Quitting application.");
-        qApp->quit();
+        quitApp();
     });
 
     setupMenus();
+    followConfigChanges();
 
     QUrl targetUrl = getTargetUrl();
 
-    if (config.useLessMemory() && config.startMinimizedInTray()) {
-        Logger::log("Low-memory startup: Delaying load of " + targetUrl.toString());
-        view->setUrl(DARK_BLANK_URL);
-
-        int interval = config.backgroundCheckInterval();
-        if (interval > 0) {
-            Logger::log(QString("Starting periodic check timer (Startup): %1 minutes").arg(interval));
-            periodicCheckTimer.start(interval * 60 * 1000);
-        }
+    if (m_managed) {
+        // The stub tells us why we were started: show() or runBackgroundCheck()
+        Logger::log("Managed startup: Web engine created on demand");
+    } else if (config.useLessMemory() && config.startMinimizedInTray()) {
+        // Tray and IPC only: Chromium is not started until the window is
+        // shown or the first background check is due.
+        Logger::log("Low-memory startup: Deferring web engine and load of " + targetUrl.toString());
+        scheduleNextCheck(true);
     } else {
+        ensureWebStack();
         Logger::log("Startup load: " + targetUrl.toString());
+        // Cold start, measured from exec
+        connect(view->page(), &QWebEnginePage::loadStarted, this, [] {
+            LatencyRecorder::record("startup.first-load-started", LatencyRecorder::sinceProcessStart());
+        }, Qt::SingleShotConnection);
+        connect(view->page(), &QWebEnginePage::loadFinished, this, [] {
+            LatencyRecorder::record("startup.first-load-finished", LatencyRecorder::sinceProcessStart());
+        }, Qt::SingleShotConnection);
         view->load(targetUrl);
     }
 
@@ -193,11 +258,119 @@ MainWindow::MainWindow(ConfigManager& config, QWidget* parent)
     }
 }
 
+void MainWindow::ensureWebStack()
+{
+    if (view)
+        return;
+
+    // After deep sleep only the view and page are gone
+    const bool rebuilding = web != nullptr;
+    QElapsedTimer rebuildTimer;
+    rebuildTimer.start();
+
+    Logger::log(rebuilding ? "Rebuilding web engine view after deep sleep" : "Creating web engine view");
+
+    view = new QWebEngineView(this);
+    setCentralWidget(view);
+
+    if (rebuilding) {
+        web->attachView(view);
+    } else {
+        web = new WebEngineHelper(view, &config, this);
+        web->initialize();
+    }
+
+    // comment by: devlinman
+    // Set background color to dark to prevent flashbangs
+    if (view->page()) {
+        view->page()->setBackgroundColor(QColor("#1e1e1e"));
+    }
+
+    // Set initial zoom level
+    view->setZoomFactor(config.zoomLevel());
+
+    if (rebuilding) {
+        lifecycle->setView(view);
+        readinessProbe->setView(view);
+        connect(view->page(), &QWebEnginePage::loadFinished, this, [rebuildTimer](bool ok) {
+            Logger::log(QString("Deep sleep: Page %1 %2 ms after rebuild")
+                    .arg(ok ? "loaded" : "failed to load")
+                    .arg(rebuildTimer.elapsed()));
+        }, Qt::SingleShotConnection);
+        return;
+    }
+
+    lifecycle = new LifecycleManager(view, this);
+    lifecycle->setDelays(config.freezeDelay(), config.discardDelay());
+
+    connect(web, &WebEngineHelper::notificationReceived, this, &MainWindow::handleMessageDetected);
+    connect(web, &WebEngineHelper::unreadChanged, this, &MainWindow::handleUnreadChanged);
+    connect(web, &WebEngineHelper::activationRequested, this, &MainWindow::showAndRaise);
+
+    // The background check ends as soon as the page is ready;
+    // activeCheckTimer is only the ceiling.
+    readinessProbe = new ReadinessProbe(view, this);
+    connect(readinessProbe, &ReadinessProbe::ready, this, [this] {
+        snapshotOverlay->dismiss();
+        if (m_showLatency.isValid() && isVisible())
+            LatencyRecorder::record(m_coldShow ? "show.cold" : "show.warm", m_showLatency.elapsed());
+        m_showLatency.invalidate();
+        finishPeriodicCheck("ready");
+    });
+    connect(readinessProbe, &ReadinessProbe::failed, this, [this] {
+        snapshotOverlay->dismiss();
+        m_showLatency.invalidate();
+        finishPeriodicCheck("load failed");
+    });
+}
+
+void MainWindow::teardownWebView()
+{
+    if (!view || isVisible() || m_isCheckingInMenu)
+        return;
+
+    Logger::log("Deep sleep: Destroying web engine view");
+    readinessProbe->setView(nullptr);
+    lifecycle->setView(nullptr);
+    web->releaseView();
+
+    // Suppress "Leave site?" dialogs while the page goes away
+    view->setProperty("suppressUnload", true);
+    QWebEngineView* oldView = view;
+    view = nullptr;
+    takeCentralWidget();
+    delete oldView;
+}
+
+void MainWindow::captureSnapshot()
+{
+    // Only worth it when the page will be gone by the next show
+    if (!config.useLessMemory() || !config.showSnapshot())
+        return;
+    if (!view || !isVisible() || isMinimized() || isPageUnloaded())
+        return;
+
+    QElapsedTimer timer;
+    timer.start();
+    qint64 bytes = snapshotOverlay->capture(view);
+    if (bytes > 0)
+        Logger::log(QString("Snapshot: Captured last frame (%1 KB in %2 ms)").arg(bytes / 1024).arg(timer.elapsed()));
+}
+
+bool MainWindow::isPageUnloaded() const
+{
+    return view->url().isEmpty()
+        || view->url() == DARK_BLANK_URL
+        || view->url().toString() == "about:blank";
+}
+
 MainWindow::~MainWindow()
 {
     clearSendMessageUrl();
     if (config.rememberWindowSize())
         config.setWindowSize(size());
+    if (m_usageUnsaved)
+        usagePredictor.save();
 
     config.sync();
 }
@@ -213,6 +386,8 @@ void MainWindow::clearSendMessageUrl()
 void MainWindow::handleIncomingUrl(const QUrl& url)
 {
     // Logger::log("Handling incoming URL: " + url.toString());
+    TRACE_SCOPE("handle-incoming-url");
+    ensureWebStack();
     showAndRaise();
 
     if (!url.isValid()) {
@@ -266,6 +441,9 @@ void MainWindow::handleIncomingUrl(const QUrl& url)
 // unified show / raise behavior
 void MainWindow::showAndRaise()
 {
+    if (!isVisible())
+        m_showLatency.start();
+
     if (isMinimized())
         setWindowState((windowState() & ~Qt::WindowMinimized) | Qt::WindowActive); // Bitwise | has lower precedence than &
 
@@ -274,28 +452,68 @@ void MainWindow::showAndRaise()
     activateWindow();
 
     m_hasUnread = false;
-    if (tray) { // be consistant
-        tray->setUnreadIndicator(false);
+    setUnreadIndicator(false);
+}
+
+void MainWindow::toggleVisibility()
+{
+    if (isVisible() && isActiveWindow() && !isMinimized()) {
+        hideToTray();
+    } else {
+        showAndRaise();
     }
 }
 
+void MainWindow::hideToTray()
+{
+    captureSnapshot();
+    hide();
+}
+
+void MainWindow::setUnreadIndicator(bool show)
+{
+    if (tray)
+        tray->setUnreadIndicator(show);
+
+    if (m_managed && m_reportedUnread != int(show)) {
+        m_reportedUnread = show;
+        notifyStub(QString("unread|%1").arg(show ? 1 : 0));
+    }
+}
+
+void MainWindow::notifyStub(const QString& message)
+{
+    if (!m_managed)
+        return;
+
+    if (!IpcManager::sendMessage(IpcManager::MainServer, message))
+        Logger::log("Managed mode: Tray stub not reachable for '" + message + "'");
+}
+
 void MainWindow::handleMessageDetected()
 {
+    if (m_isCheckingInMenu)
+        m_checkSawActivity = true;
+
     if (!isActiveWindow() || isMinimized() || !isVisible()) {
         m_hasUnread = true;
-        tray->setUnreadIndicator(true);
+        setUnreadIndicator(true);
     }
 }
 
-void MainWindow::handleUnreadChanged(bool hasUnread)
+void MainWindow::handleUnreadChanged(int unreadCount)
 {
+    // Compared when a check ends; titles seen while loading are not settled
+    m_unreadCount = unreadCount;
+
+    const bool hasUnread = unreadCount > 0;
     if (hasUnread && (!isActiveWindow() || isMinimized() || !isVisible())) {
         m_hasUnread = true;
-        tray->setUnreadIndicator(true);
+        setUnreadIndicator(true);
     }
     if (!hasUnread) { // what if user reads the message in mobile or in browser? you are still gonna show unread noti??
         m_hasUnread = false;
-        tray->setUnreadIndicator(false);
+        setUnreadIndicator(false);
         return;
     }
 }
@@ -316,19 +534,259 @@ void MainWindow::startPeriodicCheck()
     }
 }
 
+void MainWindow::runBackgroundCheck()
+{
+    if (isVisible() || m_isCheckingInMenu)
+        return;
+
+    idleExitTimer.stop();
+    performPeriodicCheck();
+}
+
+void MainWindow::prewarm(const QString& source)
+{
+    if (config.prewarmOnIntent())
+        preload(source, config.prewarmTimeout() * 1000);
+}
+
+void MainWindow::preload(const QString& source, int holdMs)
+{
+    // Managed processes start without a page whatever the memory setting
+    if (isVisible() || m_isCheckingInMenu)
+        return;
+    if (!config.useLessMemory() && !m_managed)
+        return;
+
+    // Already warm (or warming): just give the user more time
+    const bool cold = !view || isPageUnloaded()
+        || lifecycle->state() == QWebEnginePage::LifecycleState::Discarded;
+    if (!cold && !prewarmTimer.isActive())
+        return;
+
+    if (!prewarmTimer.isActive()) {
+        Logger::log("Prewarm: Show intent (" + source + "), loading page in background");
+        Trace::instant("prewarm", source);
+        m_prewarmElapsed.start();
+        m_prewarmRebuilt = !view;
+        idleExitTimer.stop();
+        deepSleepTimer.stop();
+        ensureWebStack();
+        updateMemoryState(true);
+    }
+    prewarmTimer.start(qMax(holdMs, prewarmTimer.remainingTime()));
+}
+
+void MainWindow::cancelPrewarm()
+{
+    if (isVisible() || m_isCheckingInMenu)
+        return;
+
+    Logger::log(QString("Prewarm: No show within %1 s, unloading again").arg(m_prewarmElapsed.elapsed() / 1000));
+    if (m_prewarmRebuilt) {
+        enterDeepSleep();
+    } else {
+        updateMemoryState();
+        lifecycle->discardNow();
+    }
+
+    if (m_managed)
+        idleExitTimer.start(config.stubIdleExit() * 60 * 1000);
+}
+
+void MainWindow::schedulePredictedPreload()
+{
+    // The stub decides when the managed process runs at all
+    if (!config.predictivePreload() || !config.useLessMemory() || m_managed || isVisible()) {
+        predictTimer.stop();
+        return;
+    }
+
+    const int leadSecs = config.predictiveLead() * 60;
+    const QDateTime now = QDateTime::currentDateTime();
+    const QDateTime next = usagePredictor.nextLikelyShow(now.addSecs(leadSecs));
+    if (!next.isValid()) {
+        // Nothing typical in the next day; look again later
+        Logger::log("Predictive preload: No typical open ahead (" + usagePredictor.describe() + ")");
+        predictTimer.start(6 * 60 * 60 * 1000);
+        return;
+    }
+
+    Logger::log("Predictive preload: Next typical open at " + next.toString("ddd HH:mm"));
+    predictTimer.start(qMax<qint64>(0, now.msecsTo(next) - leadSecs * 1000LL));
+}
+
+void MainWindow::handlePredictedShow()
+{
+    const int leadSecs = config.predictiveLead() * 60;
+    const QDateTime now = QDateTime::currentDateTime();
+    const QDateTime next = usagePredictor.nextLikelyShow(now);
+
+    // Also reached from the periodic re-scan: only preload when a typical open is close
+    if (next.isValid() && now.secsTo(next) <= leadSecs + 60) {
+        Logger::log("Predictive preload: Typical open at " + next.toString("HH:mm") + ", loading page");
+        preload("prediction", (config.predictiveLead() + config.predictiveWindow()) * 60 * 1000);
+        // Look past the slot we just served
+        predictTimer.start(qMax<qint64>(1000, now.msecsTo(next) + UsagePredictor::SLOT_MINUTES * 60 * 1000LL));
+        return;
+    }
+
+    schedulePredictedPreload();
+}
+
 void MainWindow::performPeriodicCheck()
 {
-    Logger::log("Periodic check: Loading in background for 30 seconds");
+    int ceiling = config.backgroundCheckTimeout();
+    Logger::log(QString("Periodic check: Loading in background (up to %1 s)").arg(ceiling));
+    m_checkTraceStart = Trace::now();
+    // A view built just for this check goes back to deep sleep afterwards
+    if (!view && !isVisible() && config.useLessMemory() && config.deepSleep())
+        m_deepSleepDue = true;
+    ensureWebStack();
     m_isCheckingInMenu = true;
+    m_checkSawActivity = false;
+    m_checkElapsed.start();
+    if (!isVisible())
+        web->setLeanMode(true);
     updateMemoryState(true);
-    activeCheckTimer.start(30000); // 30 seconds
+    readinessProbe->start(getTargetUrl());
+    activeCheckTimer.start(ceiling * 1000);
 }
 
-void MainWindow::finishPeriodicCheck()
+void MainWindow::finishPeriodicCheck(const QString& outcome)
 {
-    Logger::log("Periodic check: 30 seconds elapsed, unloading");
+    if (!m_isCheckingInMenu)
+        return;
+
+    readinessProbe->cancel();
+    activeCheckTimer.stop();
     m_isCheckingInMenu = false;
+
+    // Any change counts, also while the indicator is already up: new
+    // messages raise the count, reading them elsewhere lowers it
+    if (outcome == "ready") {
+        if (m_unreadCount != (m_settledUnread < 0 ? 0 : m_settledUnread))
+            m_checkSawActivity = true;
+        m_settledUnread = m_unreadCount;
+    }
+
+    web->setLeanMode(false);
+    // Counts only: deferred images never become requests, and what a
+    // blocked request would have weighed is unknown
+    LeanRequestInterceptor::Counts blocked = web->takeLeanCounts();
+    if (blocked.total() > 0) {
+        Logger::log(QString("Periodic check: Blocked %1 favicons, %2 media requests")
+                .arg(blocked.favicons)
+                .arg(blocked.media));
+    }
+
+    Trace::complete("periodic-check", m_checkTraceStart, outcome);
+    m_checkTraceStart = -1;
+
+    qint64 elapsedMs = m_checkElapsed.elapsed();
+    m_checkCount++;
+    m_checkTotalMs += elapsedMs;
+    if (outcome == "ready")
+        m_checkReadyCount++;
+
+    Logger::log(QString("Periodic check #%1: %2 after %3 s (unread: %4). "
+                        "Average %5 s, %6/%1 ready before the ceiling")
+            .arg(m_checkCount)
+            .arg(outcome)
+            .arg(elapsedMs / 1000.0, 0, 'f', 1)
+            .arg(m_hasUnread ? "yes" : "no")
+            .arg(m_checkTotalMs / 1000.0 / m_checkCount, 0, 'f', 1)
+            .arg(m_checkReadyCount));
+
     updateMemoryState();
+
+    if (!isVisible()) {
+        if (m_managed) {
+            // The stub owns the schedule
+            notifyStub(QString("checked|%1").arg(m_checkSawActivity ? 1 : 0));
+            idleExitTimer.start(config.stubIdleExit() * 60 * 1000);
+        } else {
+            checkScheduler.recordResult(m_checkSawActivity);
+            scheduleNextCheck(false);
+        }
+        if (m_deepSleepDue)
+            enterDeepSleep();
+    }
+}
+
+void MainWindow::enterDeepSleep()
+{
+    if (!view || isVisible())
+        return;
+
+    // Never pull the page out from under a running check
+    if (m_isCheckingInMenu) {
+        m_deepSleepDue = true;
+        return;
+    }
+    m_deepSleepDue = false;
+    Trace::instant("deep-sleep");
+
+    // Measure before and after so the trade-off can be judged per machine
+    qint64 rendererPid = view->page() ? view->page()->renderProcessPid() : 0;
+    connect(memorySampler, &MemorySampler::snapshotReady, this, [this](const MemorySnapshot& before) {
+        if (!view || isVisible())
+            return;
+        if (m_isCheckingInMenu) {
+            m_deepSleepDue = true;
+            return;
+        }
+
+        teardownWebView();
+
+        // Give the renderer time to exit before sampling again
+        QTimer::singleShot(5000, this, [this, before] {
+            connect(memorySampler, &MemorySampler::snapshotReady, this, [before](const MemorySnapshot& after) {
+                Logger::log(QString("Deep sleep: Reclaimed %1 MB (PSS %2 -> %3 MB, %4 -> %5 processes)")
+                        .arg((before.totalPssKb - after.totalPssKb) / 1024)
+                        .arg(before.totalPssKb / 1024)
+                        .arg(after.totalPssKb / 1024)
+                        .arg(before.processes.size())
+                        .arg(after.processes.size()));
+            }, Qt::SingleShotConnection);
+            memorySampler->requestSample();
+        });
+    }, Qt::SingleShotConnection);
+    memorySampler->requestSample(rendererPid);
+}
+
+void MainWindow::scheduleNextCheck(bool restart)
+{
+    int floor = config.backgroundCheckInterval();
+    if (m_managed || !config.useLessMemory() || floor <= 0) {
+        periodicCheckTimer.stop();
+        return;
+    }
+
+    checkScheduler.setBounds(floor, config.backgroundCheckMaxInterval());
+    if (restart)
+        checkScheduler.reset();
+
+    Logger::log("Background check scheduler: " + checkScheduler.describe());
+    periodicCheckTimer.start(checkScheduler.intervalMinutes() * 60 * 1000);
+}
+
+void MainWindow::quitApp()
+{
+    // The tray stub would otherwise keep the app running
+    notifyStub("quit");
+    exitUiProcess();
+}
+
+void MainWindow::restartApp()
+{
+    if (m_managed) {
+        // A new "whatsit" would only reach the stub while we are still exiting;
+        // the stub starts the next UI process once this one is gone
+        notifyStub("restart");
+    } else {
+        QProcess::startDetached(qApp->applicationFilePath());
+    }
+    exitUiProcess();
 }
 
 // SINGLE exit decision point
@@ -336,14 +794,10 @@ void MainWindow::handleExitRequest()
 {
     if (config.minimizeToTray()) {
         Logger::log("Minimizing to tray instead of quitting.");
-        hide();
+        hideToTray();
     } else {
-        clearSendMessageUrl();
         Logger::log("Quitting application.");
-        //      Suppress "Leave site?" dialogs
-        if (view)
-            view->setProperty("suppressUnload", true);
-        qApp->quit();
+        quitApp();
     }
 }
 
@@ -351,47 +805,116 @@ void MainWindow::closeEvent(QCloseEvent* event)
 {
     if (config.minimizeToTray()) {
         Logger::log("Close event ignored -> Minimizing to tray.");
-        hide();
+        hideToTray();
         event->ignore();
     } else {
-        clearSendMessageUrl();
         Logger::log("Close event accepted -> Quitting.");
-        //      Suppress "Leave site?" dialogs
-        if (view)
-            view->setProperty("suppressUnload", true);
         event->accept();
-        qApp->quit();
+        quitApp();
     }
 }
 
 void MainWindow::hideEvent(QHideEvent* event)
 {
+    TRACE_SCOPE("hide-event");
     QMainWindow::hideEvent(event);
+    snapshotOverlay->dismiss();
+    // The page is still loaded: its title is the baseline for the next check
+    if (view && !isPageUnloaded())
+        m_settledUnread = m_unreadCount;
+    m_showLatency.invalidate();
+    if (!m_isCheckingInMenu && readinessProbe)
+        readinessProbe->cancel();
     clearSendMessageUrl();
     updateMemoryState();
 
-    if (config.useLessMemory()) {
-        int interval = config.backgroundCheckInterval();
-        if (interval > 0) {
-            Logger::log(QString("Starting periodic check timer: %1 minutes").arg(interval));
-            periodicCheckTimer.start(interval * 60 * 1000);
-        }
+    scheduleNextCheck(true);
+
+    if (config.useLessMemory() && config.deepSleep() && view) {
+        Logger::log(QString("Deep sleep: Web view will be destroyed in %1 min").arg(config.deepSleepDelay()));
+        deepSleepTimer.start(config.deepSleepDelay() * 60 * 1000);
+    }
+
+    if (m_managed) {
+        notifyStub("visible|0");
+        idleExitTimer.start(config.stubIdleExit() * 60 * 1000);
+    }
+
+    schedulePredictedPreload();
+
+    if (m_usageUnsaved) {
+        usagePredictor.save();
+        m_usageUnsaved = false;
     }
 }
 
 void MainWindow::showEvent(QShowEvent* event)
 {
+    TRACE_SCOPE("show-event");
     QMainWindow::showEvent(event);
 
+    deepSleepTimer.stop();
+    m_deepSleepDue = false;
+    idleExitTimer.stop();
+    notifyStub("visible|1");
+    predictTimer.stop();
+    if (config.predictivePreload() && !m_managed) {
+        const QDateTime now = QDateTime::currentDateTime();
+        // One open per quarter hour, however often the window is toggled
+        if (!m_lastShowRecorded.isValid() || m_lastShowRecorded.secsTo(now) >= UsagePredictor::SLOT_MINUTES * 60) {
+            usagePredictor.recordShow(now);
+            m_usageUnsaved = true;
+            m_lastShowRecorded = now;
+        }
+    }
+    if (prewarmTimer.isActive()) {
+        prewarmTimer.stop();
+        Logger::log(QString("Prewarm: Shown %1 ms after intent").arg(m_prewarmElapsed.elapsed()));
+    }
+
+    // Cold show: the page has to load again, cover the wait with the last frame
+    const bool coldShow = !view || isPageUnloaded()
+        || lifecycle->state() == QWebEnginePage::LifecycleState::Discarded;
+    ensureWebStack();
+
+    lifecycle->endSession();
+    finishPeriodicCheck("interrupted by show");
+    web->setLeanMode(false);
     updateMemoryState();
+    web->retryDeferredRequests();
+
+    // Readiness decides when a cold page is usable (and drops the snapshot)
+    m_coldShow = coldShow;
+    if (coldShow) {
+        if (config.showSnapshot() && snapshotOverlay->hasSnapshot())
+            snapshotOverlay->showOver(view);
+        readinessProbe->start(getTargetUrl(), SHOW_READY_TIMEOUT_MS);
+    } else if (m_showLatency.isValid()) {
+        // Warm: usable once the resumed page has painted a frame
+        readinessProbe->startWarm(getTargetUrl());
+    }
 
     periodicCheckTimer.stop();
-    activeCheckTimer.stop();
 
     m_hasUnread = false;
+    setUnreadIndicator(false);
+}
+
+void MainWindow::handleIdleExit()
+{
+    if (isVisible() || m_isCheckingInMenu)
+        return;
 
-    if (tray) 
-        tray->setUnreadIndicator(false);
+    Logger::log(QString("Managed mode: Hidden for %1 min, exiting UI process.").arg(config.stubIdleExit()));
+    exitUiProcess();
+}
+
+void MainWindow::exitUiProcess()
+{
+    clearSendMessageUrl();
+    if (view)
+        view->setProperty("suppressUnload", true);
+    qApp->quit();
 }
 
 void MainWindow::changeEvent(QEvent* event)
@@ -399,9 +922,7 @@ void MainWindow::changeEvent(QEvent* event)
     if (event->type() == QEvent::ActivationChange) {
         if (isActiveWindow()) {
             m_hasUnread = false;
-            if (tray) {
-                tray->setUnreadIndicator(false);
-            }
+            setUnreadIndicator(false);
         }
     }
     QMainWindow::changeEvent(event);
@@ -415,21 +936,15 @@ void MainWindow::updateMemoryState(bool forceLoad)
     bool shouldBeLoaded = isVisible() || (config.useLessMemory() && forceLoad) || !config.useLessMemory();
 
     if (!shouldBeLoaded) {
-        // If hidden and memory optimization is ON, and we aren't forcing a load for a check, unload
-        if (view->url() != DARK_BLANK_URL && view->url().toString() != "about:blank") {
-            Logger::log("Use Less Memory: Unloading content to dark blank page");
-            // Suppress "Leave site?" dialogs
-            view->setProperty("suppressUnload", true);
-            view->stop();
-            view->setUrl(DARK_BLANK_URL);
-            QTimer::singleShot(1000, view, [this] {
-                if (view)
-                    view->setProperty("suppressUnload", false);
-            });
+        // If hidden and memory optimization is ON, and we aren't forcing a load for a check,
+        // let the lifecycle engine freeze and later discard the page. The session survives a freeze.
+        if (!isPageUnloaded()) {
+            lifecycle->sleep();
         }
     } else {
         // If visible OR memory optimization is OFF (or forced), ensure content is loaded
-        if (view->url().toString() == "about:blank" || view->url() == DARK_BLANK_URL) {
+        lifecycle->wake();
+        if (isPageUnloaded()) {
             Logger::log("Memory State: Ensuring content is loaded");
             if (sendMessageURL.isValid()) {
                 view->setUrl(sendMessageURL);
@@ -457,32 +972,207 @@ QUrl MainWindow::getTargetUrl() const
     return targetUrl;
 }
 
+void MainWindow::openTargetUrl()
+{
+    // An unloaded page picks up the new URL when it is next loaded
+    if (!view || isPageUnloaded())
+        return;
+
+    Logger::log("Custom URL changed, loading: " + getTargetUrl().toString());
+    view->setUrl(getTargetUrl());
+}
+
+void MainWindow::followConfigChanges()
+{
+    if (tray)
+        tray->followConfigChanges(config);
+
+    // Anything not handled here is read from config each time it is used
+    connect(&config, &ConfigManager::intChanged, this, [this](ConfigSchema::IntKey key) {
+        switch (key) {
+            case ConfigSchema::IntKey::BackgroundCheckInterval:
+            case ConfigSchema::IntKey::BackgroundCheckMaxInterval:
+                // Visible: the next hide schedules with the new bounds
+                if (!isVisible())
+                    scheduleNextCheck(true);
+                break;
+            case ConfigSchema::IntKey::FreezeDelay:
+            case ConfigSchema::IntKey::DiscardDelay:
+                if (lifecycle)
+                    lifecycle->setDelays(config.freezeDelay(), config.discardDelay());
+                break;
+            case ConfigSchema::IntKey::MemoryLadderHysteresis:
+                memoryLadder->setHysteresis(config.memoryLadderHysteresis());
+                break;
+            case ConfigSchema::IntKey::MemoryLimit:
+                if (config.memoryLimit() <= 0)
+                    memoryTimer->stop();
+                else if (!memoryTimer->isActive())
+                    memoryTimer->start(30000);
+                break;
+            case ConfigSchema::IntKey::HttpCacheMaximumSize:
+                if (web)
+                    web->applyCachePolicy();
+                break;
+            case ConfigSchema::IntKey::LogMaxSizeKb:
+            case ConfigSchema::IntKey::LogMaxFiles:
+                Logger::setRotation(config.logMaxSizeKb() * 1024LL, config.logMaxFiles());
+                break;
+            default:
+                break;
+        }
+    });
+
+    connect(&config, &ConfigManager::doubleChanged, this, [this](ConfigSchema::DoubleKey key, double value) {
+        if (key == ConfigSchema::DoubleKey::ZoomLevel && view)
+            view->setZoomFactor(value);
+    });
+
+    connect(&config, &ConfigManager::stringChanged, this, [this](ConfigSchema::StringKey key) {
+        switch (key) {
+            case ConfigSchema::StringKey::HttpCacheType:
+                if (web)
+                    web->applyCachePolicy();
+                break;
+            case ConfigSchema::StringKey::LogLevel:
+                Logger::setLevel(Logger::parseLevel(config.logLevel(),
+                    config.debugLoggingEnabled() ? Logger::Level::Debug : Logger::Level::Info));
+                break;
+            case ConfigSchema::StringKey::LogCategories:
+                Logger::setCategories(Logger::parseCategories(config.logCategories()));
+                break;
+            default:
+                break; // engine options need a restart
+        }
+    });
+
+    // The tray icon is TrayManager's
+    connect(&config, &ConfigManager::stringListChanged, this, [this](ConfigSchema::StringListKey key) {
+        if (key == ConfigSchema::StringListKey::MemoryLadder && memoryLadder)
+            memoryLadder->setSteps(config.memoryLadder().isEmpty()
+                    ? MemoryLadder::defaultSpec()
+                    : config.memoryLadder());
+    });
+
+    connect(&config, &ConfigManager::customChanged, this, [this](ConfigSchema::CustomKey key, const QString& value) {
+        if (key == ConfigSchema::CustomKey::Url) {
+            openTargetUrl();
+        } else if (key == ConfigSchema::CustomKey::AppIcon && !value.isEmpty()) {
+            ensureDesktopFile(value);
+        }
+    });
+}
+
+void MainWindow::followOption(QAction* action, ConfigSchema::BoolKey key)
+{
+    // Same value: the handler's config setter writes nothing
+    connect(&config, &ConfigManager::boolChanged, action, [action, key](ConfigSchema::BoolKey changed, bool value) {
+        if (changed == key)
+            action->setChecked(value);
+    });
+}
+
 void MainWindow::checkMemoryUsage()
 {
+    if (config.memoryLimit() <= 0)
+        return;
+
+    // Sampling happens on a worker thread; result arrives in handleMemorySnapshot()
+    qint64 rendererPid = 0;
+    if (view && view->page())
+        rendererPid = view->page()->renderProcessPid();
+    memorySampler->requestSample(rendererPid);
+}
+
+void MainWindow::handleMemorySnapshot(const MemorySnapshot& snapshot)
+{
+    Trace::counter("pss-mb", snapshot.totalPssKb / 1024);
+
     int limitGb = config.memoryLimit();
     if (limitGb <= 0)
         return;
 
-    qint64 totalRssKb = 0;
-    pid_t pgid = getpgrp();
-
-    QProcess ps;
-    ps.start("ps", { "-o", "rss=", "-g", QString::number(pgid) });
-    if (ps.waitForFinished()) {
-        QString output = ps.readAllStandardOutput();
-        QStringList lines = output.split('\n', Qt::SkipEmptyParts);
-        for (const QString& line : lines) {
-            totalRssKb += line.trimmed().toLongLong();
+    // PSS splits shared pages between the processes mapping them,
+    // so the sum is not inflated the way summed RSS is.
+    double totalGb = snapshot.totalPssKb / (1024.0 * 1024.0);
+    double usagePercent = totalGb / limitGb * 100.0;
+    if (usagePercent >= 100.0) {
+        for (const ProcessMemory& proc : snapshot.processes) {
+            Logger::log(QString("Memory: pid %1 (%2, %3) PSS %4 MB, USS %5 MB, Swap %6 MB")
+                    .arg(proc.pid)
+                    .arg(proc.name, proc.role)
+                    .arg(proc.pssKb / 1024)
+                    .arg(proc.ussKb / 1024)
+                    .arg(proc.swapKb / 1024));
         }
-    }
-
-    double totalGb = totalRssKb / (1024.0 * 1024.0);
-    if (totalGb > limitGb) {
-        Logger::log(QString("MEMORY KILL SWITCH TRIGGERED: %1 GB used, limit "
-                            "is %2 GB. Quitting.")
+        Logger::log(QString("Memory limit reached: %1 GB used (PSS), limit is %2 GB.")
                 .arg(totalGb, 0, 'f', 2)
                 .arg(limitGb));
-        qApp->quit();
+    }
+
+    memoryLadder->evaluate(usagePercent);
+}
+
+void MainWindow::handleMemoryLadderStep(MemoryLadder::Step step, double usagePercent)
+{
+    // Without a web engine the only step left that does anything is quitting
+    if (!web && step != MemoryLadder::Step::Quit)
+        return;
+
+    switch (step) {
+    case MemoryLadder::Step::ClearCache:
+        web->clearHttpCache();
+        break;
+
+    case MemoryLadder::Step::Freeze:
+        // A page on screen cannot be frozen or discarded
+        if (isVisible())
+            Logger::log("MemoryLadder: Window visible, cannot freeze page.");
+        else
+            lifecycle->freezeNow();
+        break;
+
+    case MemoryLadder::Step::Discard:
+        if (isVisible())
+            Logger::log("MemoryLadder: Window visible, cannot discard page.");
+        else
+            lifecycle->discardNow();
+        break;
+
+    case MemoryLadder::Step::RestartRenderer:
+        web->restartRenderer();
+        break;
+
+    case MemoryLadder::Step::Quit:
+        Logger::log(QString("MEMORY KILL SWITCH TRIGGERED: %1% of limit. Quitting.")
+                .arg(usagePercent, 0, 'f', 1));
+        // Managed: only the heavy process goes, the next show starts a fresh one
+        if (m_managed)
+            exitUiProcess();
+        else
+            quitApp();
+        break;
+    }
+}
+
+void MainWindow::handleSystemPressure(const QString& source)
+{
+    // Only shed a page nobody is looking at, and only when the user opted into unloading
+    if (!lifecycle || isVisible() || m_isCheckingInMenu || !config.useLessMemory())
+        return;
+
+    // One step per cooldown, not one per event
+    if (m_pressureStep.isValid() && m_pressureStep.elapsed() < PRESSURE_STEP_COOLDOWN_MS)
+        return;
+
+    if (lifecycle->state() == QWebEnginePage::LifecycleState::Active) {
+        Logger::log("System memory pressure (" + source + "): Freezing hidden page early");
+        lifecycle->freezeNow();
+        m_pressureStep.start();
+    } else if (lifecycle->state() == QWebEnginePage::LifecycleState::Frozen) {
+        Logger::log("System memory pressure (" + source + "): Discarding hidden page early");
+        lifecycle->discardNow();
+        m_pressureStep.start();
     }
 }
 
@@ -579,6 +1269,8 @@ void MainWindow::setupMenus()
     this->addAction(zoomIn);
     zoomIn->setShortcut(QKeySequence::ZoomIn);
     connect(zoomIn, &QAction::triggered, [this] {
+        if (!view)
+            return;
         qreal newZoom = view->zoomFactor() + 0.1;
         newZoom = std::round(newZoom * 10.0) / 10.0;
         view->setZoomFactor(newZoom);
@@ -591,6 +1283,8 @@ void MainWindow::setupMenus()
     this->addAction(zoomOut);
     zoomOut->setShortcut(QKeySequence::ZoomOut);
     connect(zoomOut, &QAction::triggered, [this] {
+        if (!view)
+            return;
         qreal newZoom = view->zoomFactor() - 0.1;
         newZoom = std::round(newZoom * 10.0) / 10.0;
         if (newZoom < 0.25)
@@ -605,7 +1299,8 @@ void MainWindow::setupMenus()
     this->addAction(zoomReset);
     zoomReset->setShortcut(tr("Ctrl+0"));
     connect(zoomReset, &QAction::triggered, [this] {
-        view->setZoomFactor(1.0);
+        if (view)
+            view->setZoomFactor(1.0);
         config.setZoomLevel(1.0);
     });
 
@@ -616,6 +1311,7 @@ void MainWindow::setupMenus()
     this->addAction(rememberDl);
     rememberDl->setCheckable(true);
     rememberDl->setChecked(config.rememberDownloadPaths());
+    followOption(rememberDl, ConfigSchema::BoolKey::RememberDownloadPaths);
     connect(rememberDl, &QAction::toggled,
         [&](bool v) { config.setRememberDownloadPaths(v); });
 
@@ -649,13 +1345,14 @@ void MainWindow::setupMenus()
         QIcon::fromTheme("application-exit"),
         "Quit App");
     this->addAction(quitAction);
-    connect(quitAction, &QAction::triggered, [this] { qApp->quit(); });
+    connect(quitAction, &QAction::triggered, [this] { quitApp(); });
 
     // --- Window ---
     auto* maxDef = window->addAction("Maximized by Default");
     this->addAction(maxDef);
     maxDef->setCheckable(true);
     maxDef->setChecked(config.maximizedByDefault());
+    followOption(maxDef, ConfigSchema::BoolKey::MaximizedByDefault);
     connect(maxDef, &QAction::toggled,
         [&](bool v) { config.setMaximizedByDefault(v); });
 
@@ -663,6 +1360,7 @@ void MainWindow::setupMenus()
     this->addAction(remember);
     remember->setCheckable(true);
     remember->setChecked(config.rememberWindowSize());
+    followOption(remember, ConfigSchema::BoolKey::RememberWindowSize);
     connect(remember, &QAction::toggled,
         [&](bool v) { config.setRememberWindowSize(v); });
 
@@ -670,6 +1368,7 @@ void MainWindow::setupMenus()
     this->addAction(trayOpt);
     trayOpt->setCheckable(true);
     trayOpt->setChecked(config.minimizeToTray());
+    followOption(trayOpt, ConfigSchema::BoolKey::MinimizeToTray);
     connect(trayOpt, &QAction::toggled,
         [&](bool v) { config.setMinimizeToTray(v); });
 
@@ -678,6 +1377,7 @@ void MainWindow::setupMenus()
     this->addAction(autostart);
     autostart->setCheckable(true);
     autostart->setChecked(config.autostartOnLogin());
+    followOption(autostart, ConfigSchema::BoolKey::AutostartOnLogin);
     connect(autostart, &QAction::toggled,
         [&](bool v) { config.setAutostartOnLogin(v); });
 
@@ -685,6 +1385,7 @@ void MainWindow::setupMenus()
     this->addAction(startMin);
     startMin->setCheckable(true);
     startMin->setChecked(config.startMinimizedInTray());
+    followOption(startMin, ConfigSchema::BoolKey::StartMinimizedInTray);
     connect(startMin, &QAction::toggled,
         [&](bool v) { config.setStartMinimizedInTray(v); });
 
@@ -692,15 +1393,18 @@ void MainWindow::setupMenus()
     this->addAction(trayInd);
     trayInd->setCheckable(true);
     trayInd->setChecked(config.showTrayIndicator());
+    followOption(trayInd, ConfigSchema::BoolKey::ShowTrayIndicator);
     connect(trayInd, &QAction::toggled, [&](bool v) {
         config.setShowTrayIndicator(v);
-        tray->setIndicatorEnabled(v);
+        if (tray)
+            tray->setIndicatorEnabled(v);
     });
 
     auto* notifications = system->addAction("Enable Notifications");
     this->addAction(notifications);
     notifications->setCheckable(true);
     notifications->setChecked(config.systemNotifications());
+    followOption(notifications, ConfigSchema::BoolKey::SystemNotifications);
     connect(notifications, &QAction::toggled,
         [&](bool v) { config.setSystemNotifications(v); });
 
@@ -708,9 +1412,11 @@ void MainWindow::setupMenus()
     this->addAction(mute);
     mute->setCheckable(true);
     mute->setChecked(config.muteAudio());
+    followOption(mute, ConfigSchema::BoolKey::MuteAudio);
     connect(mute, &QAction::toggled, [&](bool v) {
         config.setMuteAudio(v);
-        web->setAudioMuted(v);
+        if (web)
+            web->setAudioMuted(v);
     });
 
     // --- Advanced ---
@@ -718,29 +1424,119 @@ void MainWindow::setupMenus()
     this->addAction(debug);
     debug->setCheckable(true);
     debug->setChecked(config.debugLoggingEnabled());
+    followOption(debug, ConfigSchema::BoolKey::EnableFileLogging);
     connect(debug, &QAction::toggled, [&](bool v) {
         config.setDebugLoggingEnabled(v);
         Logger::setFileLoggingEnabled(v);
+        Logger::setLevel(Logger::parseLevel(config.logLevel(), v ? Logger::Level::Debug : Logger::Level::Info));
         Logger::log(v ? "File logging ENABLED" : "File logging DISABLED");
         if (!v) {
             Logger::deleteLogFile();
         }
     });
 
+    auto* tracing = advanced->addAction("Debug: Record Trace");
+    this->addAction(tracing);
+    tracing->setCheckable(true);
+    tracing->setChecked(Trace::enabled());
+    followOption(tracing, ConfigSchema::BoolKey::EnableTracing);
+    connect(tracing, &QAction::toggled, [this](bool v) {
+        config.setTracingEnabled(v);
+        if (v)
+            Trace::start(Trace::defaultPath());
+        else
+            Trace::stop();
+    });
+
     auto* useLessMem = advanced->addAction("Use Less Memory");
     this->addAction(useLessMem);
     useLessMem->setCheckable(true);
     useLessMem->setChecked(config.useLessMemory());
+    followOption(useLessMem, ConfigSchema::BoolKey::UseLessMemory);
     connect(useLessMem, &QAction::toggled, [this](bool v) {
         config.setUseLessMemory(v);
         updateMemoryState();
+        // Nothing unloads the page any more, so nothing shows the frame
+        if (!v)
+            snapshotOverlay->clear();
         if (v && !isVisible()) {
-            int interval = config.backgroundCheckInterval();
-            if (interval > 0)
-                periodicCheckTimer.start(interval * 60 * 1000);
+            scheduleNextCheck(true);
         } else {
             periodicCheckTimer.stop();
-            activeCheckTimer.stop();
+            finishPeriodicCheck("cancelled");
+        }
+    });
+
+    auto* reactPressure = advanced->addAction("React to System Memory Pressure");
+    this->addAction(reactPressure);
+    reactPressure->setCheckable(true);
+    reactPressure->setChecked(config.reactToSystemPressure());
+    followOption(reactPressure, ConfigSchema::BoolKey::ReactToSystemPressure);
+    connect(reactPressure, &QAction::toggled, [this](bool v) {
+        config.setReactToSystemPressure(v);
+        if (v)
+            psiMonitor->start();
+        else
+            psiMonitor->stop();
+    });
+
+    auto* showSnapshot = advanced->addAction("Show Last Snapshot While Loading");
+    this->addAction(showSnapshot);
+    showSnapshot->setCheckable(true);
+    showSnapshot->setChecked(config.showSnapshot());
+    followOption(showSnapshot, ConfigSchema::BoolKey::ShowSnapshot);
+    connect(showSnapshot, &QAction::toggled, [this](bool v) {
+        config.setShowSnapshot(v);
+        if (!v)
+            snapshotOverlay->clear();
+    });
+
+    // Off by default: the file holds a picture of open chats
+    auto* snapshotOnDisk = advanced->addAction("Keep Snapshot Across Restarts");
+    this->addAction(snapshotOnDisk);
+    snapshotOnDisk->setCheckable(true);
+    snapshotOnDisk->setChecked(config.snapshotOnDisk());
+    followOption(snapshotOnDisk, ConfigSchema::BoolKey::SnapshotOnDisk);
+    connect(snapshotOnDisk, &QAction::toggled, [this](bool v) {
+        config.setSnapshotOnDisk(v);
+        const QString path = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/last-frame.jpg";
+        if (v) {
+            snapshotOverlay->setCacheFile(path);
+        } else {
+            snapshotOverlay->setCacheFile(QString());
+            QFile::remove(path);
+        }
+    });
+
+    auto* predictive = advanced->addAction("Preload Page at Usual Times");
+    this->addAction(predictive);
+    predictive->setCheckable(true);
+    predictive->setChecked(config.predictivePreload());
+    followOption(predictive, ConfigSchema::BoolKey::PredictivePreload);
+    connect(predictive, &QAction::toggled, [this](bool v) {
+        config.setPredictivePreload(v);
+        if (v) {
+            schedulePredictedPreload();
+        } else {
+            // The pattern is personal data; do not keep it around unused
+            predictTimer.stop();
+            const QString path = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/usage-pattern.bin";
+            QFile::remove(path);
+            usagePredictor.load(path);
+            m_usageUnsaved = false;
+        }
+    });
+
+    auto* prewarmIntent = advanced->addAction("Preload Page on Tray Menu or Scroll");
+    this->addAction(prewarmIntent);
+    prewarmIntent->setCheckable(true);
+    prewarmIntent->setChecked(config.prewarmOnIntent());
+    followOption(prewarmIntent, ConfigSchema::BoolKey::PrewarmOnIntent);
+    connect(prewarmIntent, &QAction::toggled, [this](bool v) {
+        config.setPrewarmOnIntent(v);
+        if (!v && prewarmTimer.isActive()) {
+            prewarmTimer.stop();
+            cancelPrewarm();
         }
     });
 
@@ -777,6 +1573,15 @@ void MainWindow::setupMenus()
         layout->addWidget(slider);
         layout->addWidget(valueLabel);
 
+        auto* ladderLabel = new QLabel(
+            "Responses as usage approaches the threshold (step:percent).\n"
+            "Steps: cache, freeze, discard, renderer, quit", &dlg);
+        auto* ladderEdit = new QLineEdit(&dlg);
+        ladderEdit->setPlaceholderText(MemoryLadder::defaultSpec());
+        ladderEdit->setText(config.memoryLadder());
+        layout->addWidget(ladderLabel);
+        layout->addWidget(ladderEdit);
+
         auto* btnBox = new QHBoxLayout;
         auto* saveBtn = new QPushButton("Save", &dlg);
         auto* cancelBtn = new QPushButton("Cancel", &dlg);
@@ -789,6 +1594,10 @@ void MainWindow::setupMenus()
 
         if (dlg.exec() == QDialog::Accepted) {
             config.setMemoryLimit(slider->value());
+            config.setMemoryLadder(ladderEdit->text().trimmed());
+            memoryLadder->setSteps(config.memoryLadder().isEmpty()
+                    ? MemoryLadder::defaultSpec()
+                    : config.memoryLadder());
             if (slider->value() > 0) {
                 if (!memoryTimer->isActive())
                     memoryTimer->start(30000);
@@ -798,6 +1607,214 @@ void MainWindow::setupMenus()
         }
     });
 
+    auto* sleepTimers = advanced->addAction(
+        QIcon::fromTheme("system-suspend"),
+        "Page Sleep Timers");
+    this->addAction(sleepTimers);
+    connect(sleepTimers, &QAction::triggered, [this] {
+        QDialog dlg(this);
+        dlg.setWindowTitle("Page Sleep Timers");
+        dlg.setMinimumSize(600, 300);
+        auto* layout = new QVBoxLayout(&dlg);
+
+        layout->addWidget(new QLabel("Used with \"Use Less Memory\" while the window is hidden.", &dlg));
+
+        // Freeze: 0 - 10 minutes in 30 second steps
+        auto* freezeLabel = new QLabel(&dlg);
+        auto* freezeSlider = new QSlider(Qt::Horizontal, &dlg);
+        freezeSlider->setRange(0, 20);
+        freezeSlider->setTickPosition(QSlider::TicksBelow);
+        freezeSlider->setTickInterval(2);
+        freezeSlider->setValue(config.freezeDelay() / 30);
+        auto updateFreezeLabel = [freezeLabel](int val) {
+            if (val == 0)
+                freezeLabel->setText("Freeze page: Immediately after hiding");
+            else
+                freezeLabel->setText(QString("Freeze page: %1 s after hiding (session is kept)").arg(val * 30));
+        };
+        updateFreezeLabel(freezeSlider->value());
+        connect(freezeSlider, &QSlider::valueChanged, updateFreezeLabel);
+
+        // Discard: 0 (never) - 120 minutes in 10 minute steps
+        auto* discardLabel = new QLabel(&dlg);
+        auto* discardSlider = new QSlider(Qt::Horizontal, &dlg);
+        discardSlider->setRange(0, 12);
+        discardSlider->setTickPosition(QSlider::TicksBelow);
+        discardSlider->setTickInterval(1);
+        discardSlider->setValue(config.discardDelay() / 10);
+        auto updateDiscardLabel = [discardLabel](int val) {
+            if (val == 0)
+                discardLabel->setText("Discard page: Never");
+            else
+                discardLabel->setText(QString("Discard page: %1 min after hiding (full reload on show)").arg(val * 10));
+        };
+        updateDiscardLabel(discardSlider->value());
+        connect(discardSlider, &QSlider::valueChanged, updateDiscardLabel);
+
+        // Deep sleep: 0 (off) - 8 hours in 30 minute steps
+        auto* deepLabel = new QLabel(&dlg);
+        auto* deepSlider = new QSlider(Qt::Horizontal, &dlg);
+        deepSlider->setRange(0, 16);
+        deepSlider->setTickPosition(QSlider::TicksBelow);
+        deepSlider->setTickInterval(2);
+        deepSlider->setValue(config.deepSleep() ? qMax(1, config.deepSleepDelay() / 30) : 0);
+        auto updateDeepLabel = [deepLabel](int val) {
+            if (val == 0)
+                deepLabel->setText("Deep sleep: Off");
+            else
+                deepLabel->setText(QString("Deep sleep: Destroy the web view %1 min after hiding (slowest to show again)").arg(val * 30));
+        };
+        updateDeepLabel(deepSlider->value());
+        connect(deepSlider, &QSlider::valueChanged, updateDeepLabel);
+
+        layout->addWidget(freezeLabel);
+        layout->addWidget(freezeSlider);
+        layout->addWidget(discardLabel);
+        layout->addWidget(discardSlider);
+        layout->addWidget(deepLabel);
+        layout->addWidget(deepSlider);
+
+        auto* btnBox = new QHBoxLayout;
+        auto* saveBtn = new QPushButton("Save", &dlg);
+        auto* cancelBtn = new QPushButton("Cancel", &dlg);
+        btnBox->addWidget(saveBtn);
+        btnBox->addWidget(cancelBtn);
+        layout->addLayout(btnBox);
+
+        connect(saveBtn, &QPushButton::clicked, &dlg, &QDialog::accept);
+        connect(cancelBtn, &QPushButton::clicked, &dlg, &QDialog::reject);
+
+        if (dlg.exec() == QDialog::Accepted) {
+            config.setFreezeDelay(freezeSlider->value() * 30);
+            config.setDiscardDelay(discardSlider->value() * 10);
+            config.setDeepSleep(deepSlider->value() > 0);
+            if (deepSlider->value() > 0)
+                config.setDeepSleepDelay(deepSlider->value() * 30);
+            if (lifecycle)
+                lifecycle->setDelays(config.freezeDelay(), config.discardDelay());
+            if (!config.deepSleep())
+                deepSleepTimer.stop();
+        }
+    });
+
+    auto* httpCache = advanced->addAction(
+        QIcon::fromTheme("drive-harddisk"),
+        "HTTP Cache");
+    this->addAction(httpCache);
+    connect(httpCache, &QAction::triggered, [this] {
+        QDialog dlg(this);
+        dlg.setWindowTitle("HTTP Cache");
+        dlg.setMinimumSize(600, 300);
+        auto* layout = new QVBoxLayout(&dlg);
+
+        auto* typeBox = new QComboBox(&dlg);
+        typeBox->addItem("Disk", "disk");
+        typeBox->addItem("Memory only", "memory");
+        typeBox->addItem("None", "none");
+        typeBox->setCurrentIndex(qMax(0, typeBox->findData(config.httpCacheType())));
+        layout->addWidget(new QLabel("Cache type:", &dlg));
+        layout->addWidget(typeBox);
+
+        // 0 (automatic) - 1024 MB in 64 MB steps
+        auto* sizeLabel = new QLabel(&dlg);
+        auto* sizeSlider = new QSlider(Qt::Horizontal, &dlg);
+        sizeSlider->setRange(0, 16);
+        sizeSlider->setTickPosition(QSlider::TicksBelow);
+        sizeSlider->setTickInterval(1);
+        sizeSlider->setValue(config.httpCacheMaximumSize() / 64);
+        auto updateSizeLabel = [sizeLabel](int val) {
+            if (val == 0)
+                sizeLabel->setText("Maximum size: Automatic");
+            else
+                sizeLabel->setText(QString("Maximum size: %1 MB").arg(val * 64));
+        };
+        updateSizeLabel(sizeSlider->value());
+        connect(sizeSlider, &QSlider::valueChanged, updateSizeLabel);
+        layout->addWidget(sizeLabel);
+        layout->addWidget(sizeSlider);
+
+        const HttpCacheStats stats = web ? web->cacheStats() : HttpCacheStats();
+        const qint64 known = stats.hits + stats.misses;
+        layout->addWidget(new QLabel(
+            QString("This session: %1 page loads, %2 cache hits, %3 misses (%4% hit ratio)\n"
+                    "%5 KB served from cache, %6 KB from network")
+                .arg(stats.loads)
+                .arg(stats.hits)
+                .arg(stats.misses)
+                .arg(known > 0 ? stats.hits * 100 / known : 0)
+                .arg(stats.cachedBytes / 1024)
+                .arg(stats.transferredBytes / 1024),
+            &dlg));
+
+        auto* btnBox = new QHBoxLayout;
+        auto* saveBtn = new QPushButton("Save", &dlg);
+        auto* cancelBtn = new QPushButton("Cancel", &dlg);
+        btnBox->addWidget(saveBtn);
+        btnBox->addWidget(cancelBtn);
+        layout->addLayout(btnBox);
+
+        connect(saveBtn, &QPushButton::clicked, &dlg, &QDialog::accept);
+        connect(cancelBtn, &QPushButton::clicked, &dlg, &QDialog::reject);
+
+        if (dlg.exec() == QDialog::Accepted) {
+            config.setHttpCacheType(typeBox->currentData().toString());
+            config.setHttpCacheMaximumSize(sizeSlider->value() * 64);
+            if (web)
+                web->applyCachePolicy();
+        }
+    });
+
+    auto* engineMenu = advanced->addMenu(
+        QIcon::fromTheme("preferences-system-performance"),
+        "Engine Profile");
+    auto* engineGroup = new QActionGroup(engineMenu);
+    engineGroup->setExclusive(true);
+    const QString currentProfile = config.engineProfile();
+    for (const QString& name : EngineProfile::names()) {
+        auto* action = engineMenu->addAction(name);
+        action->setCheckable(true);
+        action->setChecked(name == currentProfile);
+        engineGroup->addAction(action);
+        connect(action, &QAction::triggered, [this, name] {
+            if (name == "custom") {
+                bool ok = false;
+                QString flags = QInputDialog::getText(
+                    this, "Custom Engine Flags",
+                    "Chromium switches, separated by spaces:",
+                    QLineEdit::Normal, config.customChromiumFlags(), &ok);
+                if (!ok)
+                    return;
+                config.setCustomChromiumFlags(flags.trimmed());
+            }
+            config.setEngineProfile(name);
+            Logger::log("Engine profile set to " + name);
+            QMessageBox::information(
+                this, "Restart Required",
+                "The engine profile will take effect after restarting the application.");
+        });
+    }
+
+    // Tray stub keeps a few MB resident; the web engine only runs while needed
+    auto* splitProcess = advanced->addAction("Run Web Engine Only When Needed");
+    this->addAction(splitProcess);
+    splitProcess->setCheckable(true);
+    splitProcess->setChecked(config.splitProcess());
+    connect(splitProcess, &QAction::toggled, [this](bool v) {
+        config.setSplitProcess(v);
+        if (v) {
+            bool ok = false;
+            int minutes = QInputDialog::getInt(
+                this, "Run Web Engine Only When Needed",
+                "Exit the web engine after the window has been hidden for (minutes):",
+                config.stubIdleExit(), 1, 24 * 60, 1, &ok);
+            if (ok)
+                config.setStubIdleExit(minutes);
+        }
+        QMessageBox::information(
+            this, "Restart Required",
+            "Changes will take effect after restarting the application.");
+    });
+
     advanced->addSeparator();
 
     auto* reload = advanced->addAction(
@@ -809,8 +1826,7 @@ void MainWindow::setupMenus()
                      QStandardPaths::GenericCacheLocation)
                 + "/whatsit")
                 .removeRecursively();
-            QProcess::startDetached(qApp->applicationFilePath());
-            qApp->quit();
+            restartApp();
         });
     this->addAction(reload);
 
@@ -820,8 +1836,9 @@ void MainWindow::setupMenus()
             Logger::log("Deleting profile and restarting...");
             QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation))
                 .removeRecursively();
-            QProcess::startDetached(qApp->applicationFilePath());
-            qApp->quit();
+            // The cached frame is a picture of the deleted profile's chats
+            snapshotOverlay->clear();
+            restartApp();
         });
     this->addAction(delProfile);
 
@@ -862,11 +1879,39 @@ void MainWindow::setupMenus()
             if (val == 0)
                 intervalLabel->setText("Background Check: Disabled");
             else
-                intervalLabel->setText(QString("Background Check: Every %1 min\n(App wakes up, loads page, waits 30s, then sleeps)").arg(val));
+                intervalLabel->setText(QString("Background Check: Every %1 min or more\n(App wakes up, loads page, waits until synced, then sleeps)").arg(val));
         };
         updateIntervalLabel(intervalSlider->value());
         connect(intervalSlider, &QSlider::valueChanged, updateIntervalLabel);
 
+        // Back-off ceiling when checks find nothing: 10 - 120 min
+        auto* maxIntervalSlider = new QSlider(Qt::Horizontal, &dlg);
+        maxIntervalSlider->setRange(1, 12);
+        maxIntervalSlider->setTickPosition(QSlider::TicksBelow);
+        maxIntervalSlider->setTickInterval(1);
+        maxIntervalSlider->setValue(qBound(1, config.backgroundCheckMaxInterval() / 10, 12));
+
+        auto* maxIntervalLabel = new QLabel(&dlg);
+        auto updateMaxIntervalLabel = [maxIntervalLabel](int val) {
+            maxIntervalLabel->setText(QString("When nothing new arrives, slow down to every %1 min").arg(val * 10));
+        };
+        updateMaxIntervalLabel(maxIntervalSlider->value());
+        connect(maxIntervalSlider, &QSlider::valueChanged, updateMaxIntervalLabel);
+
+        // Ceiling for one check: 30 - 180 s in 15 second steps
+        auto* timeoutSlider = new QSlider(Qt::Horizontal, &dlg);
+        timeoutSlider->setRange(2, 12);
+        timeoutSlider->setTickPosition(QSlider::TicksBelow);
+        timeoutSlider->setTickInterval(1);
+        timeoutSlider->setValue(qBound(2, config.backgroundCheckTimeout() / 15, 12));
+
+        auto* timeoutLabel = new QLabel(&dlg);
+        auto updateTimeoutLabel = [timeoutLabel](int val) {
+            timeoutLabel->setText(QString("Give up on a check after %1 s").arg(val * 15));
+        };
+        updateTimeoutLabel(timeoutSlider->value());
+        connect(timeoutSlider, &QSlider::valueChanged, updateTimeoutLabel);
+
         if (!currentTrayIcon.isEmpty()) {
             trayIconBtn->setText(currentTrayIcon);
             QIcon tempIcon = QIcon::fromTheme(currentTrayIcon);
@@ -924,6 +1969,10 @@ void MainWindow::setupMenus()
         layout->addRow("App Icon:", appIconBtn);
         layout->addRow("Wake Up:", intervalLabel);
         layout->addRow("", intervalSlider);
+        layout->addRow("", maxIntervalLabel);
+        layout->addRow("", maxIntervalSlider);
+        layout->addRow("", timeoutLabel);
+        layout->addRow("", timeoutSlider);
 
         layout->addItem(new QSpacerItem(0, 10, QSizePolicy::Minimum, QSizePolicy::Fixed));
         layout->addRow("", tooltipCheck);
@@ -940,6 +1989,7 @@ void MainWindow::setupMenus()
         connect(cancelBtn, &QPushButton::clicked, &dlg, &QDialog::reject);
 
         connect(removeBtn, &QPushButton::clicked, [&] {
+            const QString oldUrl = config.customUrl();
             config.removeCustomConfig();
             config.setBackgroundCheckInterval(0); // Reset interval
             config.setShowTrayTooltip(true); // Default
@@ -947,7 +1997,10 @@ void MainWindow::setupMenus()
             // Immediately update the tray icon
             if (tray) {
                 tray->setIcon("whatsit");
+                tray->setTooltipEnabled(true);
             }
+            if (!oldUrl.isEmpty())
+                openTargetUrl();
             QString local_share_apps_dir = QStandardPaths::writableLocation(
                 QStandardPaths::ApplicationsLocation);
             QDir appsDir(local_share_apps_dir);
@@ -967,15 +2020,18 @@ void MainWindow::setupMenus()
             rebuildKCache();
             QMessageBox::information(
                 &dlg, "Customizations Removed",
-                "Custom settings have been removed. Restart to see changes.");
+                "Custom settings have been removed.");
             dlg.reject();
         });
 
         if (dlg.exec() == QDialog::Accepted) {
+            const bool urlChanged = urlEdit->text() != config.customUrl();
             config.setCustomUrl(urlEdit->text());
             config.setCustomTrayIcon(selectedTrayIcon);
             config.setCustomAppIcon(selectedAppIcon);
             config.setBackgroundCheckInterval(intervalSlider->value());
+            config.setBackgroundCheckTimeout(timeoutSlider->value() * 15);
+            config.setBackgroundCheckMaxInterval(maxIntervalSlider->value() * 10);
             config.setShowTrayTooltip(tooltipCheck->isChecked());
 
             if (tray) {
@@ -991,9 +2047,9 @@ void MainWindow::setupMenus()
                 ensureDesktopFile(selectedAppIcon);
             }
 
-            QMessageBox::information(
-                this, "Restart Required",
-                "Changes will take effect after restarting the application.");
+            // Background check bounds are picked up by the next hide
+            if (urlChanged)
+                openTargetUrl();
         }
     });
 }
@@ -4,21 +4,40 @@
 #include <QMainWindow>
 #include <QUrl>
 #include <memory>
+#include "checkscheduler.h"
 #include "configmanager.h"
+#include "memoryladder.h"
+#include "usagepredictor.h"
+#include <QDateTime>
+#include <QElapsedTimer>
 #include <QTimer>
 
+class QAction;
 class QWebEngineView;
 class WebEngineHelper;
 class TrayManager;
 class IpcManager;
+class LifecycleManager;
+class MemorySampler;
+class PsiMonitor;
+class ReadinessProbe;
+class SnapshotOverlay;
+struct MemorySnapshot;
 
 class MainWindow : public QMainWindow {
     Q_OBJECT
 
   public:
-    explicit MainWindow(ConfigManager& config, QWidget *parent = nullptr); // inherit config from main
+    // managed: started by the whatsit-tray stub (split-process mode). The stub
+    // owns tray and schedule; this process only shows the page and checks.
+    explicit MainWindow(ConfigManager& config, bool managed = false, QWidget *parent = nullptr); // inherit config from main
     ~MainWindow() override;
 
+    // Run one background check now (managed mode: requested by the stub)
+    void runBackgroundCheck();
+    // A show is probably coming: start loading a hidden, unloaded page early
+    void prewarm(const QString &source);
+
   protected:
     void closeEvent(QCloseEvent *event) override;
     void hideEvent(QHideEvent *event) override;
@@ -27,24 +46,59 @@ class MainWindow : public QMainWindow {
 
   private slots:
     void checkMemoryUsage();
+    void handleMemorySnapshot(const MemorySnapshot &snapshot);
+    void handleMemoryLadderStep(MemoryLadder::Step step, double usagePercent);
+    void handleSystemPressure(const QString &source);
     void handleIncomingUrl(const QUrl &url);
     void clearSendMessageUrl();
     void handleMessageDetected();
-    void handleUnreadChanged(bool hasUnread);
+    void handleUnreadChanged(int unreadCount);
     void startPeriodicCheck();
     void performPeriodicCheck();
-    void finishPeriodicCheck();
+    void finishPeriodicCheck(const QString &outcome);
+    void toggleVisibility();
+    // Every hide we initiate goes through here, while the page is still on screen
+    void hideToTray();
+    void handleIdleExit();
+    void cancelPrewarm();
+    void handlePredictedShow();
+    void enterDeepSleep();
 
   private:
     void setupMenus();
+    // Apply options edited on disk (or by the tray stub) without a restart
+    void followConfigChanges();
+    // The check mark follows the option on disk; the toggled handler applies it
+    void followOption(QAction *action, ConfigSchema::BoolKey key);
+    // Custom URL changed: leave the loaded page for the new one
+    void openTargetUrl();
     void ensureDesktopFile(const QString &iconPath);
     void rebuildKCache();
     void handleExitRequest();
+    // Every way out of the app; tells the tray stub in managed mode
+    void quitApp();
+    void restartApp();
+    // Ends this process without "Leave site?"; on its own, in managed
+    // mode the stub keeps the tray and starts a new UI on the next show
+    void exitUiProcess();
     void updateMemoryState(bool forceLoad = false);
+    // Build view, page and helpers on first use (lazy low-memory startup)
+    void ensureWebStack();
+    bool isPageUnloaded() const;
+    void captureSnapshot();
+    // Load the hidden page now and keep it for holdMs unless a show follows
+    void preload(const QString &source, int holdMs);
+    void schedulePredictedPreload();
+    // Destroy view and page, keep profile and helpers for ensureWebStack()
+    void teardownWebView();
+    void scheduleNextCheck(bool restart);
     QUrl getTargetUrl() const;
 
     // unified tray/window behavior
     void showAndRaise();
+    void setUnreadIndicator(bool show);
+    // Managed mode only: report to the tray stub
+    void notifyStub(const QString &message);
 
     QWebEngineView *view;
     QUrl sendMessageURL;
@@ -53,9 +107,45 @@ class MainWindow : public QMainWindow {
     WebEngineHelper *web;
     TrayManager *tray;
     IpcManager *ipc;
+    LifecycleManager *lifecycle;
     QTimer *memoryTimer;
+    MemorySampler *memorySampler;
+    MemoryLadder *memoryLadder;
+    PsiMonitor *psiMonitor;
+    ReadinessProbe *readinessProbe;
+    SnapshotOverlay *snapshotOverlay;
     QTimer periodicCheckTimer;
     QTimer activeCheckTimer;
+    QTimer deepSleepTimer;
+    QTimer idleExitTimer;
+    QTimer prewarmTimer;
+    QElapsedTimer m_prewarmElapsed;
+    // Tray click / IPC raise until the page is usable
+    QElapsedTimer m_showLatency;
+    bool m_coldShow = false;
+    bool m_prewarmRebuilt = false; // view did not exist before the prewarm
+    // Last page step taken on system memory pressure
+    QElapsedTimer m_pressureStep;
+
+    // Predictive preload
+    UsagePredictor usagePredictor;
+    QTimer predictTimer;
+    QDateTime m_lastShowRecorded;
+    bool m_usageUnsaved = false; // written on hide and exit, never while showing
+    bool m_managed = false;
+    int m_reportedUnread = -1;
+    bool m_deepSleepDue = false;
     bool m_hasUnread = false;
+    int m_unreadCount = 0;      // last count the title showed
+    int m_settledUnread = -1;   // count at the last hide or ready check; -1 = not known yet
     bool m_isCheckingInMenu = false; // why are we using this?
+
+    // Background check bookkeeping
+    QElapsedTimer m_checkElapsed;
+    qint64 m_checkTraceStart = -1;
+    bool m_checkSawActivity = false;
+    CheckScheduler checkScheduler;
+    int m_checkCount = 0;
+    int m_checkReadyCount = 0;
+    qint64 m_checkTotalMs = 0;
 };
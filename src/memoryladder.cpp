@@ -0,0 +1,119 @@
+// memoryladder.cpp
+#include "memoryladder.h"
+#include "logger.h"
+
+#include <QRegularExpression>
+#include <algorithm>
+
+namespace {
+
+    struct StepKey {
+        const char *key;
+        MemoryLadder::Step step;
+    };
+
+    const StepKey STEP_KEYS[] = {
+        { "cache", MemoryLadder::Step::ClearCache },
+        { "freeze", MemoryLadder::Step::Freeze },
+        { "discard", MemoryLadder::Step::Discard },
+        { "renderer", MemoryLadder::Step::RestartRenderer },
+        { "quit", MemoryLadder::Step::Quit },
+    };
+
+}
+
+MemoryLadder::MemoryLadder(QObject *parent)
+: QObject(parent)
+{
+    setSteps(defaultSpec());
+}
+
+QString MemoryLadder::defaultSpec()
+{
+    return "cache:70 freeze:80 discard:85 renderer:95 quit:100";
+}
+
+QString MemoryLadder::stepName(Step step)
+{
+    for (const StepKey &entry : STEP_KEYS) {
+        if (entry.step == step)
+            return entry.key;
+    }
+    return "unknown";
+}
+
+void MemoryLadder::setSteps(const QString &spec)
+{
+    m_rungs.clear();
+
+    static const QRegularExpression separators("[\\s,;]+");
+    const QStringList entries = spec.split(separators, Qt::SkipEmptyParts);
+    for (const QString &entry : entries) {
+        const QStringList parts = entry.split(':');
+        bool ok = false;
+        const int percent = parts.value(1).toInt(&ok);
+        if (parts.size() != 2 || !ok || percent <= 0) {
+            Logger::log("MemoryLadder: Ignoring malformed step: " + entry);
+            continue;
+        }
+
+        const QString key = parts.at(0).trimmed().toLower();
+        auto it = std::find_if(std::begin(STEP_KEYS), std::end(STEP_KEYS),
+                               [&key](const StepKey &s) { return key == s.key; });
+        if (it == std::end(STEP_KEYS)) {
+            Logger::log("MemoryLadder: Unknown step: " + entry);
+            continue;
+        }
+        m_rungs.append({ it->step, percent });
+    }
+
+    std::sort(m_rungs.begin(), m_rungs.end(),
+              [](const Rung &a, const Rung &b) { return a.percent < b.percent; });
+}
+
+void MemoryLadder::setHysteresis(int percent)
+{
+    m_hysteresis = std::max(0, percent);
+}
+
+void MemoryLadder::reset()
+{
+    for (Rung &rung : m_rungs)
+        rung.engaged = false;
+}
+
+void MemoryLadder::evaluate(double usagePercent)
+{
+    // Re-arm rungs once usage has dropped clearly below them
+    for (Rung &rung : m_rungs) {
+        if (rung.engaged && usagePercent < rung.percent - m_hysteresis) {
+            Logger::log(QString("MemoryLadder: Re-arming '%1' at %2%")
+                            .arg(stepName(rung.step))
+                            .arg(usagePercent, 0, 'f', 1));
+            rung.engaged = false;
+        }
+    }
+
+    // Climb at most one rung per sample so cheaper steps get a chance to work.
+    // Quit is the hard limit and is never postponed.
+    Rung *next = nullptr;
+    for (Rung &rung : m_rungs) {
+        if (rung.engaged || usagePercent < rung.percent)
+            continue;
+        if (rung.step == Step::Quit) {
+            next = &rung;
+            break;
+        }
+        if (!next)
+            next = &rung;
+    }
+
+    if (!next)
+        return;
+
+    next->engaged = true;
+    Logger::log(QString("MemoryLadder: Usage %1% of limit -> '%2'")
+                    .arg(usagePercent, 0, 'f', 1)
+                    .arg(stepName(next->step)));
+    emit stepTriggered(next->step, usagePercent);
+}
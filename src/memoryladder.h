@@ -0,0 +1,50 @@
+// memoryladder.h
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+
+// Escalating responses to memory usage approaching the kill switch limit.
+// Each rung fires once when usage crosses its threshold and re-arms only
+// after usage drops below (threshold - hysteresis), so it does not flap.
+class MemoryLadder : public QObject
+{
+    Q_OBJECT
+public:
+    enum class Step {
+        ClearCache,
+        Freeze,
+        Discard,
+        RestartRenderer,
+        Quit
+    };
+    Q_ENUM(Step)
+
+    explicit MemoryLadder(QObject *parent = nullptr);
+
+    // Space separated "step:percent" pairs, e.g. "cache:70 freeze:80 quit:100".
+    // Steps: cache, freeze, discard, renderer, quit. Unknown entries are ignored.
+    void setSteps(const QString &spec);
+    void setHysteresis(int percent);
+
+    // usagePercent: current usage as a percentage of the configured limit
+    void evaluate(double usagePercent);
+    void reset();
+
+    static QString defaultSpec();
+    static QString stepName(Step step);
+
+signals:
+    void stepTriggered(MemoryLadder::Step step, double usagePercent);
+
+private:
+    struct Rung {
+        Step step;
+        int percent;
+        bool engaged = false;
+    };
+
+    QVector<Rung> m_rungs;
+    int m_hysteresis = 5;
+};
@@ -0,0 +1,172 @@
+// memorysampler.cpp
+#include "memorysampler.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QHash>
+#include <QSet>
+#include <unistd.h>
+
+namespace {
+
+    QByteArray readProcFile(qint64 pid, const char *name)
+    {
+        QFile file(QString("/proc/%1/%2").arg(pid).arg(name));
+        if (!file.open(QIODevice::ReadOnly))
+            return {};
+        return file.readAll();
+    }
+
+    // "/proc/<pid>/stat": "pid (comm) state ppid ..."; comm may contain spaces
+    qint64 readParentPid(qint64 pid)
+    {
+        const QByteArray stat = readProcFile(pid, "stat");
+        const int close = stat.lastIndexOf(')');
+        if (close < 0)
+            return -1;
+        const QList<QByteArray> fields = stat.mid(close + 2).split(' ');
+        if (fields.size() < 2)
+            return -1;
+        return fields.at(1).toLongLong();
+    }
+
+    QString readRole(qint64 pid)
+    {
+        if (pid == getpid())
+            return "browser";
+
+        const QList<QByteArray> args = readProcFile(pid, "cmdline").split('\0');
+        for (const QByteArray &arg : args) {
+            if (arg.startsWith("--type="))
+                return QString::fromUtf8(arg.mid(7));
+        }
+        return "other";
+    }
+
+    qint64 fieldKb(const QByteArray &line)
+    {
+        // "Pss:                1234 kB"
+        const int colon = line.indexOf(':');
+        return line.mid(colon + 1).trimmed().split(' ').value(0).toLongLong();
+    }
+
+    bool readRollup(ProcessMemory &proc)
+    {
+        QByteArray data = readProcFile(proc.pid, "smaps_rollup");
+        if (data.isEmpty()) {
+            // Kernels older than 4.14 (or no permission): RSS is all we get
+            data = readProcFile(proc.pid, "status");
+            if (data.isEmpty())
+                return false;
+            for (const QByteArray &line : data.split('\n')) {
+                if (line.startsWith("VmRSS:")) {
+                    proc.rssKb = fieldKb(line);
+                    proc.pssKb = proc.rssKb;
+                    proc.ussKb = proc.rssKb;
+                } else if (line.startsWith("VmSwap:")) {
+                    proc.swapKb = fieldKb(line);
+                }
+            }
+            return true;
+        }
+
+        qint64 swap = 0;
+        qint64 swapPss = -1;
+        for (const QByteArray &line : data.split('\n')) {
+            if (line.startsWith("Rss:"))
+                proc.rssKb = fieldKb(line);
+            else if (line.startsWith("Pss:"))
+                proc.pssKb = fieldKb(line);
+            else if (line.startsWith("Private_Clean:") || line.startsWith("Private_Dirty:"))
+                proc.ussKb += fieldKb(line);
+            else if (line.startsWith("SwapPss:"))
+                swapPss = fieldKb(line);
+            else if (line.startsWith("Swap:"))
+                swap = fieldKb(line);
+        }
+        proc.swapKb = swapPss >= 0 ? swapPss : swap;
+        return true;
+    }
+
+}
+
+void MemorySamplerWorker::sample(qint64 rendererPid)
+{
+    // Map every visible process to its parent, then walk down from our PID.
+    QHash<qint64, QVector<qint64>> children;
+    QHash<qint64, qint64> parents;
+    const QStringList entries = QDir("/proc").entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QString &entry : entries) {
+        bool ok = false;
+        const qint64 pid = entry.toLongLong(&ok);
+        if (!ok)
+            continue;
+        const qint64 ppid = readParentPid(pid);
+        if (ppid < 0)
+            continue;
+        parents.insert(pid, ppid);
+        children[ppid].append(pid);
+    }
+
+    QVector<qint64> tree { getpid() };
+    for (int i = 0; i < tree.size(); ++i)
+        tree += children.value(tree.at(i));
+
+    if (rendererPid > 0 && !tree.contains(rendererPid) && parents.contains(rendererPid))
+        tree.append(rendererPid);
+
+    MemorySnapshot snapshot;
+    snapshot.timestampMs = QDateTime::currentMSecsSinceEpoch();
+
+    for (qint64 pid : tree) {
+        ProcessMemory proc;
+        proc.pid = pid;
+        proc.ppid = parents.value(pid);
+        if (!readRollup(proc))
+            continue; // exited while we were looking
+        proc.name = QString::fromUtf8(readProcFile(pid, "comm").trimmed());
+        proc.role = pid == rendererPid ? "renderer" : readRole(pid);
+
+        snapshot.totalRssKb += proc.rssKb;
+        snapshot.totalPssKb += proc.pssKb;
+        snapshot.totalUssKb += proc.ussKb;
+        snapshot.totalSwapKb += proc.swapKb;
+        snapshot.processes.append(proc);
+    }
+
+    emit snapshotReady(snapshot);
+}
+
+MemorySampler::MemorySampler(QObject *parent)
+: QObject(parent),
+m_worker(new MemorySamplerWorker)
+{
+    qRegisterMetaType<MemorySnapshot>();
+
+    m_thread.setObjectName("whatsit-memsampler");
+    m_worker->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+    connect(m_worker, &MemorySamplerWorker::snapshotReady, this, [this](const MemorySnapshot &snapshot) {
+        m_busy = false;
+        emit snapshotReady(snapshot);
+    });
+    m_thread.start(QThread::LowPriority);
+}
+
+MemorySampler::~MemorySampler()
+{
+    m_thread.quit();
+    m_thread.wait();
+}
+
+void MemorySampler::requestSample(qint64 rendererPid)
+{
+    // Skip if the previous sample is still running
+    if (m_busy.exchange(true))
+        return;
+
+    QMetaObject::invokeMethod(m_worker, [worker = m_worker, rendererPid] {
+        worker->sample(rendererPid);
+    }, Qt::QueuedConnection);
+}
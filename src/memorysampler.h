@@ -0,0 +1,68 @@
+// memorysampler.h
+#pragma once
+
+#include <QMetaType>
+#include <QObject>
+#include <QString>
+#include <QThread>
+#include <QVector>
+#include <atomic>
+
+// Memory of a single process, as reported by /proc/<pid>/smaps_rollup.
+struct ProcessMemory {
+    qint64 pid = 0;
+    qint64 ppid = 0;
+    QString name;   // /proc/<pid>/comm
+    QString role;   // browser, renderer, gpu-process, utility, zygote...
+    qint64 rssKb = 0;
+    qint64 pssKb = 0;
+    qint64 ussKb = 0;  // Private_Clean + Private_Dirty
+    qint64 swapKb = 0; // SwapPss when available, Swap otherwise
+};
+
+// Whole process tree (our PID + all descendants + the current renderer).
+struct MemorySnapshot {
+    QVector<ProcessMemory> processes;
+    qint64 timestampMs = 0;
+    qint64 totalRssKb = 0;
+    qint64 totalPssKb = 0;
+    qint64 totalUssKb = 0;
+    qint64 totalSwapKb = 0;
+};
+
+Q_DECLARE_METATYPE(MemorySnapshot)
+
+// Lives on the sampler thread; does the actual /proc parsing.
+class MemorySamplerWorker : public QObject
+{
+    Q_OBJECT
+public:
+    using QObject::QObject;
+
+public slots:
+    void sample(qint64 rendererPid);
+
+signals:
+    void snapshotReady(const MemorySnapshot &snapshot);
+};
+
+// Fork-free memory sampler. requestSample() returns immediately; the
+// result is delivered through snapshotReady() on the caller's thread.
+class MemorySampler : public QObject
+{
+    Q_OBJECT
+public:
+    explicit MemorySampler(QObject *parent = nullptr);
+    ~MemorySampler() override;
+
+    // rendererPid: QWebEnginePage::renderProcessPid(), or 0 if unknown
+    void requestSample(qint64 rendererPid = 0);
+
+signals:
+    void snapshotReady(const MemorySnapshot &snapshot);
+
+private:
+    QThread m_thread;
+    MemorySamplerWorker *m_worker;
+    std::atomic_bool m_busy { false };
+};
@@ -0,0 +1,97 @@
+// psimonitor.cpp
+#include "psimonitor.h"
+#include "logger.h"
+
+#include <QFile>
+#include <QSocketNotifier>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+PsiMonitor::PsiMonitor(QObject *parent)
+: QObject(parent)
+{
+}
+
+PsiMonitor::~PsiMonitor()
+{
+    stop();
+}
+
+bool PsiMonitor::start(int stallMs, int windowMs)
+{
+    stop();
+
+    // "some <stall us> <window us>"
+    const QByteArray spec = QByteArray("some ")
+                            + QByteArray::number(stallMs * 1000LL) + ' '
+                            + QByteArray::number(windowMs * 1000LL);
+
+    addTrigger("/proc/pressure/memory", "system", spec);
+
+    const QString cgroupPath = cgroupPressurePath();
+    if (!cgroupPath.isEmpty())
+        addTrigger(cgroupPath, "cgroup", spec);
+
+    if (m_triggers.isEmpty()) {
+        Logger::log("PsiMonitor: No PSI trigger available; system pressure is not monitored.");
+        return false;
+    }
+    return true;
+}
+
+void PsiMonitor::stop()
+{
+    for (const Trigger &trigger : m_triggers) {
+        delete trigger.notifier;
+        ::close(trigger.fd);
+    }
+    m_triggers.clear();
+}
+
+bool PsiMonitor::addTrigger(const QString &path, const QString &source, const QByteArray &spec)
+{
+    const int fd = ::open(QFile::encodeName(path).constData(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        Logger::log(QString("PsiMonitor: Cannot open %1: %2").arg(path, QString::fromLocal8Bit(strerror(errno))));
+        return false;
+    }
+
+    // The kernel expects the trigger string including its terminating NUL
+    if (::write(fd, spec.constData(), spec.size() + 1) < 0) {
+        Logger::log(QString("PsiMonitor: Cannot register trigger on %1: %2").arg(path, QString::fromLocal8Bit(strerror(errno))));
+        ::close(fd);
+        return false;
+    }
+
+    // PSI events are delivered as POLLPRI, which QSocketNotifier calls Exception
+    auto *notifier = new QSocketNotifier(fd, QSocketNotifier::Exception, this);
+    connect(notifier, &QSocketNotifier::activated, this, [this, source] {
+        emit pressureDetected(source);
+    });
+
+    m_triggers.append({ fd, notifier, source });
+    Logger::log(QString("PsiMonitor: Watching %1 (%2)").arg(path, QString::fromLatin1(spec)));
+    return true;
+}
+
+QString PsiMonitor::cgroupPressurePath()
+{
+    // cgroup v2 entry looks like "0::/user.slice/user-1000.slice/..."
+    QFile file("/proc/self/cgroup");
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+
+    const QList<QByteArray> lines = file.readAll().split('\n');
+    for (const QByteArray &line : lines) {
+        if (!line.startsWith("0::"))
+            continue;
+        const QString cgroup = QString::fromUtf8(line.mid(3).trimmed());
+        if (cgroup.isEmpty() || cgroup == "/")
+            return {}; // root cgroup is the same as the system-wide file
+        const QString path = "/sys/fs/cgroup" + cgroup + "/memory.pressure";
+        return QFile::exists(path) ? path : QString();
+    }
+    return {};
+}
@@ -0,0 +1,42 @@
+// psimonitor.h
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+
+class QSocketNotifier;
+
+// Watches kernel pressure stall information (PSI) for memory.
+// Registers triggers on /proc/pressure/memory and, when available, on the
+// memory.pressure file of our own cgroup v2; the kernel wakes us through
+// POLLPRI, so nothing is polled while the system is healthy.
+class PsiMonitor : public QObject
+{
+    Q_OBJECT
+public:
+    explicit PsiMonitor(QObject *parent = nullptr);
+    ~PsiMonitor() override;
+
+    // stallMs of "some" memory stall within windowMs fires the trigger.
+    // Unprivileged triggers need windowMs to be a multiple of 2000.
+    // Returns false if no trigger could be registered (no PSI support).
+    bool start(int stallMs = 200, int windowMs = 2000);
+    void stop();
+
+signals:
+    // source: "system" or "cgroup"
+    void pressureDetected(const QString &source);
+
+private:
+    struct Trigger {
+        int fd = -1;
+        QSocketNotifier *notifier = nullptr;
+        QString source;
+    };
+
+    bool addTrigger(const QString &path, const QString &source, const QByteArray &spec);
+    static QString cgroupPressurePath();
+
+    QVector<Trigger> m_triggers;
+};
@@ -0,0 +1,209 @@
+// readinessprobe.cpp
+#include "readinessprobe.h"
+#include "logger.h"
+
+#include <QVariantMap>
+#include <QWebEnginePage>
+#include <QWebEngineView>
+
+namespace {
+
+    constexpr int POLL_INTERVAL_MS = 1000;
+    // Warm probe: about one frame
+    constexpr int WARM_POLL_INTERVAL_MS = 16;
+    // A warm page that is not usable by then is not warm (navigated away, hung)
+    constexpr int WARM_TIMEOUT_MS = 5000;
+    // Title (unread count) must be unchanged this long
+    constexpr int TITLE_QUIET_MS = 3000;
+    // Consecutive polls without new resource timing entries
+    constexpr int NETWORK_IDLE_POLLS = 2;
+    // A settled page with neither landmark (markup changed, an error
+    // page) counts as ready after this many idle polls
+    constexpr int SETTLED_WITHOUT_LANDMARK_POLLS = 10;
+
+    const QString PROBE_SCRIPT = QStringLiteral(R"(
+(function() {
+    return {
+        complete: document.readyState === 'complete',
+        host: location.host,
+        chatList: !!document.querySelector('#pane-side'),
+        loginScreen: !!document.querySelector('[data-ref], canvas[aria-label]'),
+        resources: performance.getEntriesByType('resource').length
+    };
+})();
+)");
+
+    // %1: probe token. The first poll asks for a frame; later polls report
+    // whether it has been painted. A frozen page runs neither until resumed.
+    const QString WARM_PROBE_SCRIPT = QStringLiteral(R"(
+(function() {
+    var mark = window.__whatsitFrame;
+    if (!mark || mark.token !== %1) {
+        mark = window.__whatsitFrame = { token: %1, painted: false };
+        requestAnimationFrame(function() { mark.painted = true; });
+    }
+    return {
+        complete: document.readyState === 'complete',
+        host: location.host,
+        chatList: !!document.querySelector('#pane-side'),
+        loginScreen: !!document.querySelector('[data-ref], canvas[aria-label]'),
+        painted: mark.painted
+    };
+})();
+)");
+
+}
+
+ReadinessProbe::ReadinessProbe(QWebEngineView *view, QObject *parent)
+: QObject(parent),
+m_view(view)
+{
+    m_pollTimer.setInterval(POLL_INTERVAL_MS);
+    connect(&m_pollTimer, &QTimer::timeout, this, &ReadinessProbe::poll);
+}
+
+void ReadinessProbe::setView(QWebEngineView *view)
+{
+    cancel();
+    m_view = view;
+}
+
+void ReadinessProbe::startWarm(const QUrl &target)
+{
+    start(target, WARM_TIMEOUT_MS);
+    if (!m_running)
+        return;
+
+    m_warm = true;
+    m_warmToken++;
+    m_pollTimer.start(WARM_POLL_INTERVAL_MS);
+    poll();
+}
+
+void ReadinessProbe::start(const QUrl &target, int timeoutMs)
+{
+    cancel();
+    m_target = target;
+    m_timeoutMs = timeoutMs;
+
+    m_page = m_view ? m_view->page() : nullptr;
+    if (!m_page)
+        return;
+
+    connect(m_page, &QWebEnginePage::loadFinished, this, &ReadinessProbe::handleLoadFinished);
+    connect(m_page, &QWebEnginePage::titleChanged, this, &ReadinessProbe::handleTitleChanged);
+    connect(m_page, &QWebEnginePage::loadStarted, this, &ReadinessProbe::restartQuietPeriods);
+    connect(m_page, &QWebEnginePage::urlChanged, this, &ReadinessProbe::restartQuietPeriods);
+
+    m_running = true;
+    m_elapsed.start();
+    m_titleQuiet.start();
+    m_pollTimer.start(POLL_INTERVAL_MS);
+}
+
+void ReadinessProbe::cancel()
+{
+    if (m_page)
+        disconnect(m_page, nullptr, this, nullptr);
+
+    m_running = false;
+    m_warm = false;
+    m_pollPending = false;
+    m_lastResourceCount = -1;
+    m_idlePolls = 0;
+    m_pollTimer.stop();
+}
+
+bool ReadinessProbe::isRunning() const
+{
+    return m_running;
+}
+
+void ReadinessProbe::handleLoadFinished(bool ok)
+{
+    if (!ok && m_running) {
+        Logger::log("ReadinessProbe: Page failed to load");
+        cancel();
+        emit failed();
+    }
+}
+
+void ReadinessProbe::handleTitleChanged()
+{
+    m_titleQuiet.restart();
+}
+
+void ReadinessProbe::restartQuietPeriods()
+{
+    m_navigation++;
+    m_pollPending = false;
+    m_lastResourceCount = -1;
+    m_idlePolls = 0;
+    m_titleQuiet.restart();
+}
+
+void ReadinessProbe::poll()
+{
+    if (!m_running || !m_page)
+        return;
+
+    // Before the pending check: a hung renderer never answers the last poll
+    if (m_timeoutMs > 0 && m_elapsed.elapsed() > m_timeoutMs) {
+        Logger::log(QString("ReadinessProbe: %1 page not usable within %2 ms")
+                .arg(m_warm ? "Warm" : "Cold").arg(m_timeoutMs));
+        cancel();
+        emit failed();
+        return;
+    }
+    if (m_pollPending)
+        return;
+
+    m_pollPending = true;
+    QPointer<ReadinessProbe> self(this);
+    const int navigation = m_navigation;
+    const QString script = m_warm ? WARM_PROBE_SCRIPT.arg(m_warmToken) : PROBE_SCRIPT;
+    m_page->runJavaScript(script, [self, navigation](const QVariant &result) {
+        if (!self || !self->m_running || navigation != self->m_navigation)
+            return;
+        self->m_pollPending = false;
+
+        // The blank placeholder shown while the real navigation is still
+        // uncommitted is complete and idle too
+        const QVariantMap r = result.toMap();
+        if (r.isEmpty() || !r.value("complete").toBool()
+            || r.value("host").toString() != self->m_target.host()) {
+            self->m_idlePolls = 0;
+            return;
+        }
+
+        // Custom URLs have no chat list to wait for; a logged-out session
+        // settles on the QR code instead
+        const bool appReady = self->m_target.host() != "web.whatsapp.com"
+            || r.value("chatList").toBool() || r.value("loginScreen").toBool();
+
+        if (self->m_warm) {
+            if (appReady && r.value("painted").toBool()) {
+                self->cancel();
+                emit self->ready();
+            }
+            return;
+        }
+
+        const int resources = r.value("resources").toInt();
+        if (resources == self->m_lastResourceCount)
+            self->m_idlePolls++;
+        else
+            self->m_idlePolls = 0;
+        self->m_lastResourceCount = resources;
+
+        if (self->m_idlePolls < NETWORK_IDLE_POLLS || self->m_titleQuiet.elapsed() < TITLE_QUIET_MS)
+            return;
+        if (!appReady) {
+            if (self->m_idlePolls < SETTLED_WITHOUT_LANDMARK_POLLS)
+                return;
+            Logger::log("ReadinessProbe: Page settled without a chat list or login screen");
+        }
+        self->cancel();
+        emit self->ready();
+    });
+}
@@ -0,0 +1,61 @@
+// readinessprobe.h
+#pragma once
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+#include <QUrl>
+
+class QWebEnginePage;
+class QWebEngineView;
+
+// Decides when a background check has seen everything it is going to see:
+// the target document is committed and complete, the WhatsApp chat list
+// (or, logged out, the QR code) is rendered, the title (unread count) has stopped changing and no new
+// resources are arriving. startWarm() is the fast path for a page that was
+// already loaded: usable once it is the target and has painted a frame.
+class ReadinessProbe : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ReadinessProbe(QWebEngineView *view, QObject *parent = nullptr);
+
+    // Cancels a running probe before switching views
+    void setView(QWebEngineView *view);
+
+    // target: the page being waited for; a blank placeholder never counts.
+    // timeoutMs > 0: failed() if not ready by then, else the caller's ceiling
+    void start(const QUrl &target, int timeoutMs = 0);
+    void startWarm(const QUrl &target);
+    void cancel();
+    bool isRunning() const;
+
+signals:
+    void ready();
+    void failed();
+
+private slots:
+    void handleLoadFinished(bool ok);
+    void handleTitleChanged();
+    // A new navigation: nothing seen so far counts
+    void restartQuietPeriods();
+    void poll();
+
+private:
+    QWebEngineView *m_view;
+    QPointer<QWebEnginePage> m_page;
+    QTimer m_pollTimer;
+    QElapsedTimer m_titleQuiet;
+    QElapsedTimer m_elapsed;
+    QUrl m_target;
+    int m_timeoutMs = 0;
+
+    bool m_running = false;
+    bool m_warm = false;
+    int m_warmToken = 0; // tells our requestAnimationFrame mark from an earlier probe's
+    bool m_pollPending = false;
+    int m_lastResourceCount = -1;
+    int m_idlePolls = 0;
+    int m_navigation = 0; // results of polls from an earlier navigation are dropped
+};
@@ -0,0 +1,176 @@
+// renderersupervisor.cpp
+#include "renderersupervisor.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <csignal>
+
+namespace {
+
+    constexpr int INITIAL_BACKOFF_MS = 1000;
+    constexpr int MAX_BACKOFF_MS = 5 * 60 * 1000;
+    // A renderer that survived this long after loading resets the backoff
+    constexpr int STABLE_AFTER_MS = 60 * 1000;
+    constexpr int HEARTBEAT_INTERVAL_MS = 30 * 1000;
+    constexpr int HEARTBEAT_TIMEOUT_MS = 15 * 1000;
+
+    QString statusName(QWebEnginePage::RenderProcessTerminationStatus status)
+    {
+        switch (status) {
+            case QWebEnginePage::NormalTerminationStatus:
+                return "normal";
+            case QWebEnginePage::AbnormalTerminationStatus:
+                return "abnormal";
+            case QWebEnginePage::CrashedTerminationStatus:
+                return "crashed";
+            case QWebEnginePage::KilledTerminationStatus:
+                return "killed";
+        }
+        return "unknown";
+    }
+
+}
+
+RendererSupervisor::RendererSupervisor(QObject *parent)
+: QObject(parent),
+m_backoffMs(INITIAL_BACKOFF_MS)
+{
+    m_reloadTimer.setSingleShot(true);
+    connect(&m_reloadTimer, &QTimer::timeout, this, &RendererSupervisor::reload);
+
+    m_stableTimer.setSingleShot(true);
+    connect(&m_stableTimer, &QTimer::timeout, this, [this] {
+        m_backoffMs = INITIAL_BACKOFF_MS;
+    });
+
+    m_heartbeatTimeout.setSingleShot(true);
+    connect(&m_heartbeatTimeout, &QTimer::timeout, this, &RendererSupervisor::handleHeartbeatTimeout);
+
+    connect(&m_heartbeatTimer, &QTimer::timeout, this, &RendererSupervisor::sendHeartbeat);
+    m_heartbeatTimer.start(HEARTBEAT_INTERVAL_MS);
+}
+
+void RendererSupervisor::attach(QWebEnginePage *page)
+{
+    if (m_page)
+        disconnect(m_page, nullptr, this, nullptr);
+
+    m_page = page;
+    m_reloadTimer.stop();
+    m_heartbeatTimeout.stop();
+    m_expectExit = false;
+
+    if (!page)
+        return;
+
+    connect(page, &QWebEnginePage::renderProcessTerminated,
+            this, &RendererSupervisor::handleTerminated);
+    connect(page, &QWebEnginePage::loadFinished,
+            this, &RendererSupervisor::handleLoadFinished);
+}
+
+void RendererSupervisor::recycle(const QString &reason)
+{
+    if (!m_page)
+        return;
+
+    const qint64 pid = m_page->renderProcessPid();
+    if (pid <= 0) {
+        Logger::log("RendererSupervisor: No renderer process to recycle");
+        return;
+    }
+
+    Logger::log(QString("RendererSupervisor: Recycling renderer %1 (%2)").arg(pid).arg(reason));
+    m_heartbeatTimeout.stop();
+    m_expectExit = true;
+    ::kill(static_cast<pid_t>(pid), SIGKILL);
+}
+
+int RendererSupervisor::crashCount() const
+{
+    return m_crashCount;
+}
+
+int RendererSupervisor::hangCount() const
+{
+    return m_hangCount;
+}
+
+void RendererSupervisor::handleTerminated(QWebEnginePage::RenderProcessTerminationStatus status, int exitCode)
+{
+    m_stableTimer.stop();
+    m_heartbeatTimeout.stop();
+
+    if (m_expectExit) {
+        m_expectExit = false;
+        Logger::log("RendererSupervisor: Renderer stopped on request. Reloading.");
+        reload();
+        return;
+    }
+
+    // Discarding a page ends its renderer on purpose
+    if (status == QWebEnginePage::NormalTerminationStatus ||
+        (m_page && m_page->lifecycleState() == QWebEnginePage::LifecycleState::Discarded)) {
+        Logger::log("RendererSupervisor: Renderer exited normally.");
+        return;
+    }
+
+    ++m_crashCount;
+    Logger::log(QString("RendererSupervisor: Renderer %1 (exit code %2). Crashes: %3, hangs: %4. Reloading in %5 ms")
+                    .arg(statusName(status))
+                    .arg(exitCode)
+                    .arg(m_crashCount)
+                    .arg(m_hangCount)
+                    .arg(m_backoffMs));
+
+    m_reloadTimer.start(m_backoffMs);
+    m_backoffMs = std::min(m_backoffMs * 2, MAX_BACKOFF_MS);
+}
+
+void RendererSupervisor::handleLoadFinished(bool ok)
+{
+    if (ok)
+        m_stableTimer.start(STABLE_AFTER_MS);
+}
+
+void RendererSupervisor::sendHeartbeat()
+{
+    // Frozen/discarded pages do not run script; a pending heartbeat is still in flight
+    if (!m_page || m_heartbeatTimeout.isActive() || m_reloadTimer.isActive())
+        return;
+    if (m_page->lifecycleState() != QWebEnginePage::LifecycleState::Active ||
+        m_page->renderProcessPid() <= 0)
+        return;
+
+    const quint64 seq = ++m_heartbeatSeq;
+    QPointer<RendererSupervisor> self(this);
+    m_heartbeatTimeout.start(HEARTBEAT_TIMEOUT_MS);
+    m_page->runJavaScript("1", [self, seq](const QVariant &) {
+        if (self && seq == self->m_heartbeatSeq)
+            self->m_heartbeatTimeout.stop();
+    });
+}
+
+void RendererSupervisor::handleHeartbeatTimeout()
+{
+    if (!m_page)
+        return;
+
+    // The page may have been frozen while the heartbeat was pending
+    if (m_page->lifecycleState() != QWebEnginePage::LifecycleState::Active)
+        return;
+
+    ++m_hangCount;
+    Logger::log(QString("RendererSupervisor: Renderer did not answer within %1 ms. Crashes: %2, hangs: %3")
+                    .arg(HEARTBEAT_TIMEOUT_MS)
+                    .arg(m_crashCount)
+                    .arg(m_hangCount));
+    recycle("hang");
+}
+
+void RendererSupervisor::reload()
+{
+    if (!m_page)
+        return;
+    m_page->triggerAction(QWebEnginePage::Reload);
+}
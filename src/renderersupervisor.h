@@ -0,0 +1,49 @@
+// renderersupervisor.h
+#pragma once
+
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+#include <QWebEnginePage>
+
+// Keeps the page's renderer process alive:
+// - reloads after a crash, with exponential backoff between attempts
+// - sends a periodic JavaScript heartbeat and recycles a renderer that
+//   stops answering
+class RendererSupervisor : public QObject
+{
+    Q_OBJECT
+public:
+    explicit RendererSupervisor(QObject *parent = nullptr);
+
+    // Called whenever a new page is put into the view
+    void attach(QWebEnginePage *page);
+
+    // Kill the current renderer and reload in a fresh one. Not counted as a crash.
+    void recycle(const QString &reason);
+
+    int crashCount() const;
+    int hangCount() const;
+
+private slots:
+    void handleTerminated(QWebEnginePage::RenderProcessTerminationStatus status, int exitCode);
+    void handleLoadFinished(bool ok);
+    void sendHeartbeat();
+    void handleHeartbeatTimeout();
+    void reload();
+
+private:
+    QPointer<QWebEnginePage> m_page;
+
+    QTimer m_reloadTimer;
+    QTimer m_stableTimer;
+    QTimer m_heartbeatTimer;
+    QTimer m_heartbeatTimeout;
+
+    int m_backoffMs;
+    bool m_expectExit = false;
+    quint64 m_heartbeatSeq = 0;
+
+    int m_crashCount = 0;
+    int m_hangCount = 0;
+};
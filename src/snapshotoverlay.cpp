@@ -0,0 +1,191 @@
+// snapshotoverlay.cpp
+#include "snapshotoverlay.h"
+#include "logger.h"
+
+#include <QBuffer>
+#include <QEvent>
+#include <QFile>
+#include <QFileInfo>
+#include <QLocale>
+#include <QPainter>
+#include <QSaveFile>
+
+namespace {
+
+    // Never cover the page for longer than this, ready or not
+    constexpr int MAX_SHOW_MS = 30000;
+
+    // Start at half resolution; quality and size step down to meet the cap
+    constexpr int START_QUALITY = 70;
+    constexpr int MIN_QUALITY = 30;
+    constexpr int MAX_SHRINK_STEPS = 3;
+
+}
+
+SnapshotOverlay::SnapshotOverlay(QWidget *parent)
+: QWidget(parent)
+{
+    hide();
+    setCursor(Qt::BusyCursor);
+
+    m_timeout.setSingleShot(true);
+    connect(&m_timeout, &QTimer::timeout, this, &SnapshotOverlay::dismiss);
+}
+
+void SnapshotOverlay::setMaxBytes(qint64 bytes)
+{
+    m_maxBytes = qMax<qint64>(16 * 1024, bytes);
+}
+
+void SnapshotOverlay::setCacheFile(const QString &path)
+{
+    m_cacheFile = path;
+    if (m_cacheFile.isEmpty() || !m_jpeg.isEmpty())
+        return;
+
+    QFile file(m_cacheFile);
+    if (file.size() > m_maxBytes || !file.open(QIODevice::ReadOnly))
+        return;
+
+    m_jpeg = file.readAll();
+    m_capturedAt = QFileInfo(file).lastModified();
+    Logger::log(QString("SnapshotOverlay: Loaded cached snapshot (%1 KB)").arg(m_jpeg.size() / 1024));
+}
+
+qint64 SnapshotOverlay::capture(QWidget *source)
+{
+    if (!source || !source->isVisible())
+        return 0;
+
+    QImage image = source->grab().toImage();
+    if (image.isNull())
+        return 0;
+
+    image = image.scaled(image.size() / 2, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+
+    QByteArray data;
+    for (int step = 0; step < MAX_SHRINK_STEPS; ++step) {
+        for (int quality = START_QUALITY; quality >= MIN_QUALITY; quality -= 20) {
+            data.clear();
+            QBuffer buffer(&data);
+            buffer.open(QIODevice::WriteOnly);
+            image.save(&buffer, "JPG", quality);
+            if (data.size() <= m_maxBytes)
+                break;
+        }
+        if (data.size() <= m_maxBytes)
+            break;
+        image = image.scaled(image.size() / 2, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    }
+
+    if (data.isEmpty() || data.size() > m_maxBytes)
+        return 0;
+
+    m_jpeg = data;
+    m_capturedAt = QDateTime::currentDateTime();
+
+    if (!m_cacheFile.isEmpty()) {
+        QSaveFile file(m_cacheFile);
+        if (file.open(QIODevice::WriteOnly)) {
+            file.write(m_jpeg);
+            file.commit();
+        }
+    }
+
+    return m_jpeg.size();
+}
+
+bool SnapshotOverlay::hasSnapshot() const
+{
+    return !m_jpeg.isEmpty();
+}
+
+void SnapshotOverlay::clear()
+{
+    dismiss();
+    m_jpeg.clear();
+    if (!m_cacheFile.isEmpty())
+        QFile::remove(m_cacheFile);
+}
+
+void SnapshotOverlay::showOver(QWidget *target)
+{
+    if (!target || m_jpeg.isEmpty())
+        return;
+
+    m_image = QImage::fromData(m_jpeg, "JPG");
+    if (m_image.isNull())
+        return;
+
+    if (m_target)
+        m_target->removeEventFilter(this);
+    m_target = target;
+    m_target->installEventFilter(this);
+
+    followTarget();
+    show();
+    raise();
+
+    m_shownFor.start();
+    m_timeout.start(MAX_SHOW_MS);
+}
+
+void SnapshotOverlay::dismiss()
+{
+    m_timeout.stop();
+    if (m_target)
+        m_target->removeEventFilter(this);
+    m_target = nullptr;
+
+    if (isVisible())
+        Logger::log(QString("SnapshotOverlay: Covered the page for %1 ms").arg(m_shownFor.elapsed()));
+
+    hide();
+    m_image = QImage();
+}
+
+void SnapshotOverlay::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    painter.drawImage(rect(), m_image);
+
+    // Dim it, so it does not pass for the live page
+    painter.fillRect(rect(), QColor(0, 0, 0, 120));
+
+    const QString text = QString("Reconnecting... (snapshot from %1)")
+        .arg(QLocale().toString(m_capturedAt.time(), QLocale::ShortFormat));
+    QFont font = painter.font();
+    font.setBold(true);
+    painter.setFont(font);
+
+    const QRect textRect = painter.fontMetrics().boundingRect(text).adjusted(-12, -6, 12, 6);
+    const QRect pill(QPoint((width() - textRect.width()) / 2, 16), textRect.size());
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QColor(30, 30, 30, 220));
+    painter.drawRoundedRect(pill, pill.height() / 2.0, pill.height() / 2.0);
+    painter.setPen(Qt::white);
+    painter.drawText(pill, Qt::AlignCenter, text);
+}
+
+void SnapshotOverlay::mousePressEvent(QMouseEvent *)
+{
+    // A stale frame must not swallow clicks meant for the page
+    dismiss();
+}
+
+bool SnapshotOverlay::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched == m_target && (event->type() == QEvent::Resize || event->type() == QEvent::Move))
+        followTarget();
+    return QWidget::eventFilter(watched, event);
+}
+
+void SnapshotOverlay::followTarget()
+{
+    if (!m_target || !parentWidget())
+        return;
+
+    setGeometry(QRect(m_target->mapTo(parentWidget(), QPoint(0, 0)), m_target->size()));
+}
@@ -0,0 +1,52 @@
+// snapshotoverlay.h
+#pragma once
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QPointer>
+#include <QTimer>
+#include <QWidget>
+
+// Last rendered frame of the page, shown dimmed over the view while an
+// unloaded or discarded page loads again. The frame is kept JPEG-compressed
+// under a size cap, in memory and optionally in a cache file so it survives
+// a restart (lazy startup, split-process mode).
+class SnapshotOverlay : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit SnapshotOverlay(QWidget *parent = nullptr);
+
+    void setMaxBytes(qint64 bytes);
+    // Empty path: memory only. An existing file is loaded right away.
+    void setCacheFile(const QString &path);
+
+    // Grab source at reduced size; returns the compressed size, 0 on failure
+    qint64 capture(QWidget *source);
+    bool hasSnapshot() const;
+    // Forget the frame, including the cache file
+    void clear();
+
+    // Cover target until dismiss() or the timeout
+    void showOver(QWidget *target);
+    void dismiss();
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    void followTarget();
+
+    QByteArray m_jpeg;
+    QDateTime m_capturedAt;
+    QImage m_image; // decoded only while shown
+    QPointer<QWidget> m_target;
+    QString m_cacheFile;
+    qint64 m_maxBytes = 512 * 1024;
+    QTimer m_timeout;
+    QElapsedTimer m_shownFor;
+};
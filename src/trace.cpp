@@ -0,0 +1,171 @@
+// trace.cpp
+#include "trace.h"
+#include "logger.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QStandardPaths>
+#include <QThread>
+
+#include <time.h>
+
+namespace Trace {
+
+    namespace detail {
+        std::atomic_bool s_enabled { false };
+    }
+
+    namespace {
+
+        QMutex s_mutex;
+        QFile s_file;
+        qint64 s_pid = 0;
+        bool s_firstEvent = true;
+
+        QByteArray escaped(const QString &text)
+        {
+            QByteArray out;
+            const QByteArray utf8 = text.toUtf8();
+            out.reserve(utf8.size() + 8);
+            for (char c : utf8) {
+                switch (c) {
+                    case '"':  out += "\\\""; break;
+                    case '\\': out += "\\\\"; break;
+                    case '\n': out += "\\n"; break;
+                    case '\r': out += "\\r"; break;
+                    case '\t': out += "\\t"; break;
+                    default:
+                        if (static_cast<unsigned char>(c) < 0x20)
+                            out += QByteArray("\\u00") + QByteArray::number(int(c), 16).rightJustified(2, '0');
+                        else
+                            out += c;
+                }
+            }
+            return out;
+        }
+
+        qint64 threadId()
+        {
+            return static_cast<qint64>(reinterpret_cast<quintptr>(QThread::currentThreadId()) & 0x7fffffff);
+        }
+
+        // Caller builds everything except the common fields
+        void write(const char *name, char phase, qint64 ts, const QByteArray &extra)
+        {
+            QByteArray line;
+            line.reserve(128 + extra.size());
+            line += "{\"name\":\"";
+            line += escaped(QString::fromUtf8(name));
+            line += "\",\"cat\":\"whatsit\",\"ph\":\"";
+            line += phase;
+            line += "\",\"ts\":";
+            line += QByteArray::number(ts);
+            line += ",\"pid\":";
+            line += QByteArray::number(s_pid);
+            line += ",\"tid\":";
+            line += QByteArray::number(threadId());
+            line += extra;
+            line += "}";
+
+            // QFile buffers; a crash loses at most the last buffer's worth
+            QMutexLocker lock(&s_mutex);
+            if (!s_file.isOpen())
+                return;
+            if (!s_firstEvent)
+                s_file.write(",\n");
+            s_firstEvent = false;
+            s_file.write(line);
+        }
+
+        QByteArray detailArgs(const QString &detail)
+        {
+            if (detail.isEmpty())
+                return QByteArray();
+            return ",\"args\":{\"detail\":\"" + escaped(detail) + "\"}";
+        }
+
+    }
+
+    bool start(const QString &path)
+    {
+        stop();
+
+        QMutexLocker lock(&s_mutex);
+        QDir().mkpath(QFileInfo(path).absolutePath());
+        s_file.setFileName(path);
+        if (!s_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            Logger::log("Trace: Cannot open " + path);
+            return false;
+        }
+
+        // The closing bracket is optional in the trace-event format,
+        // which is what makes streaming (and surviving a crash) possible
+        s_file.write("[\n");
+        s_firstEvent = true;
+        s_pid = QCoreApplication::applicationPid();
+        detail::s_enabled = true;
+        Logger::log("Trace: Recording to " + path);
+        return true;
+    }
+
+    void stop()
+    {
+        QMutexLocker lock(&s_mutex);
+        if (!s_file.isOpen())
+            return;
+
+        detail::s_enabled = false;
+        s_file.write("\n]\n");
+        s_file.close();
+        Logger::log("Trace: Stopped, written to " + s_file.fileName());
+    }
+
+    QString defaultPath()
+    {
+        return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)
+            + QString("/traces/whatsit-%1-%2.json")
+                .arg(QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss"))
+                .arg(QCoreApplication::applicationPid());
+    }
+
+    QString processPath(const QString &path, const QString &role)
+    {
+        const QFileInfo info(path);
+        const QString suffix = info.suffix().isEmpty() ? QString("json") : info.suffix();
+        return info.dir().filePath(QString("%1-%2-%3.%4")
+            .arg(info.completeBaseName(), role)
+            .arg(QCoreApplication::applicationPid())
+            .arg(suffix));
+    }
+
+    qint64 now()
+    {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return qint64(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+    }
+
+    namespace detail {
+
+        void writeComplete(const char *name, qint64 startUs, const QString &detail)
+        {
+            write(name, 'X', startUs, ",\"dur\":" + QByteArray::number(now() - startUs) + detailArgs(detail));
+        }
+
+        void writeInstant(const char *name, const QString &detail)
+        {
+            write(name, 'i', now(), ",\"s\":\"t\"" + detailArgs(detail));
+        }
+
+        void writeCounter(const char *name, qint64 value)
+        {
+            write(name, 'C', now(), ",\"args\":{\"value\":" + QByteArray::number(value) + "}");
+        }
+
+    }
+
+}
@@ -0,0 +1,79 @@
+// trace.h
+#pragma once
+
+#include <QString>
+#include <atomic>
+
+// Trace events in Chrome trace-event JSON, for Perfetto (ui.perfetto.dev)
+// or chrome://tracing. Events are streamed to the file as they happen, so
+// a trace from a crashed or killed process is still readable.
+//
+// Disabled (the default) every call is one relaxed atomic load, and the
+// arguments are not formatted.
+namespace Trace {
+
+    namespace detail {
+        extern std::atomic_bool s_enabled;
+        void writeComplete(const char *name, qint64 startUs, const QString &detail);
+        void writeInstant(const char *name, const QString &detail);
+        void writeCounter(const char *name, qint64 value);
+    }
+
+    inline bool enabled() { return detail::s_enabled.load(std::memory_order_relaxed); }
+
+    // Opens (truncates) path and starts recording; false if it cannot be written
+    bool start(const QString &path);
+    void stop();
+    // Where start() puts a trace when no path is given
+    QString defaultPath();
+    // path with the role and this process's pid before the suffix, so the
+    // tray stub and each UI it launches get their own file from one setting
+    QString processPath(const QString &path, const QString &role);
+
+    // Microseconds on CLOCK_MONOTONIC, shared by every process on the
+    // machine so traces from the stub and its UIs line up when merged;
+    // pair with complete() for spans that begin and end in different functions
+    qint64 now();
+
+    inline void complete(const char *name, qint64 startUs, const QString &detail = QString())
+    {
+        if (enabled() && startUs >= 0)
+            detail::writeComplete(name, startUs, detail);
+    }
+
+    inline void instant(const char *name, const QString &detail = QString())
+    {
+        if (enabled())
+            detail::writeInstant(name, detail);
+    }
+
+    inline void counter(const char *name, qint64 value)
+    {
+        if (enabled())
+            detail::writeCounter(name, value);
+    }
+
+    // Span from construction to end of scope
+    class Scope
+    {
+    public:
+        explicit Scope(const char *name)
+        : m_name(name),
+        m_start(enabled() ? now() : -1)
+        {}
+
+        ~Scope() { complete(m_name, m_start); }
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        const char *m_name;
+        qint64 m_start;
+    };
+
+}
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) Trace::Scope TRACE_CONCAT(traceScope_, __LINE__)(name)
@@ -0,0 +1,60 @@
+// traymain.cpp
+// Entry point of whatsit-tray, the resident half of split-process mode.
+// Links no Qt WebEngine; see TrayStub.
+#include "configmanager.h"
+#include "ipcmanager.h"
+#include "logger.h"
+#include "trace.h"
+#include "traystub.h"
+#include <QApplication>
+#include <QUrl>
+
+int main(int argc, char *argv[]) {
+    Logger::installCrashHandler();
+    Logger::log("Tray stub starting...");
+
+    // Before QApplication: see main.cpp
+    QString command;
+    QString url;
+    for (int i = 1; i < argc; ++i) {
+        const QString arg = QString::fromLocal8Bit(argv[i]);
+        if (arg == "show" || arg == "hide")
+            command = arg;
+        else if (arg.startsWith("http") || arg.startsWith("whatsapp"))
+            url = arg;
+    }
+
+    // Single-instance check: a running stub (or full instance) takes over
+    if (IpcManager::notifyExistingInstance(command == "hide" ? "hide" : "raise", url)) {
+        return 0;
+    }
+
+    QApplication app(argc, argv);
+    app.setApplicationName("whatsit");
+    app.setOrganizationName("whatsit");
+    app.setDesktopFileName("whatsit");
+    app.setQuitOnLastWindowClosed(false);
+
+    ConfigManager config;
+    config.load();
+    Logger::setRotation(config.logMaxSizeKb() * 1024LL, config.logMaxFiles());
+    Logger::setFileLoggingEnabled(config.debugLoggingEnabled());
+    Logger::setLevel(Logger::parseLevel(config.logLevel(),
+        config.debugLoggingEnabled() ? Logger::Level::Debug : Logger::Level::Info));
+    Logger::setCategories(Logger::parseCategories(config.logCategories()));
+
+    const QString tracePath = qEnvironmentVariable("WHATSIT_TRACE");
+    if (!tracePath.isEmpty())
+        Trace::start(Trace::processPath(tracePath, "tray"));
+    else if (config.tracingEnabled())
+        Trace::start(Trace::defaultPath());
+    QObject::connect(&app, &QCoreApplication::aboutToQuit, [] { Trace::stop(); });
+    QObject::connect(&app, &QCoreApplication::aboutToQuit, &config, &ConfigManager::sync);
+
+    TrayStub stub(config);
+    if (!stub.initialize())
+        return 1;
+    stub.start(command, QUrl(url));
+
+    return app.exec();
+}
@@ -1,5 +1,8 @@
 // traymanager.cpp
 #include "traymanager.h"
+#include "configmanager.h"
+#include "logger.h"
+#include "trace.h"
 #include <KStatusNotifierItem>
 #include <QIcon>
 #include <QMenu>
@@ -28,9 +31,19 @@ void TrayManager::initialize()
 
     tray->setContextMenu(menu);
 
+    connect(menu, &QMenu::aboutToShow, this, [this] {
+        emit intentDetected("menu");
+    });
+    connect(tray, &KStatusNotifierItem::scrollRequested, this, [this] {
+        emit intentDetected("scroll");
+    });
+
     // Left-click on tray icon
     connect(tray, &KStatusNotifierItem::activateRequested,
         this, &TrayManager::activated);
+    connect(tray, &KStatusNotifierItem::activateRequested, this, [] {
+        Trace::instant("tray-activated");
+    });
 }
 
 void TrayManager::setIcon(const QString &iconName)
@@ -68,6 +81,26 @@ void TrayManager::setTooltipEnabled(bool enabled)
     updateTooltip();
 }
 
+void TrayManager::followConfigChanges(const ConfigManager &config)
+{
+    connect(&config, &ConfigManager::boolChanged, this, [this](ConfigSchema::BoolKey key, bool value) {
+        if (key == ConfigSchema::BoolKey::ShowTrayTooltip)
+            setTooltipEnabled(value);
+        else if (key == ConfigSchema::BoolKey::ShowTrayIndicator)
+            setIndicatorEnabled(value);
+    });
+    connect(&config, &ConfigManager::customChanged, this, [this](ConfigSchema::CustomKey key, const QString &value) {
+        if (key != ConfigSchema::CustomKey::TrayIcon)
+            return;
+        QString iconName = value;
+        if (!iconName.isEmpty() && QIcon::fromTheme(iconName).isNull() && QIcon(iconName).isNull()) {
+            Logger::log("TrayManager: Custom tray icon not found, using default: " + iconName);
+            iconName.clear();
+        }
+        setIcon(iconName);
+    });
+}
+
 void TrayManager::updateTooltip()
 {
     if (!tray) return;
@@ -87,6 +120,7 @@ void TrayManager::updateTooltip()
 void TrayManager::updateIcon()
 {
     if (!tray) return;
+    TRACE_SCOPE("tray-update-icon");
 
     QIcon icon = QIcon::fromTheme(m_currentIconName);
     if (icon.isNull())
@@ -3,6 +3,7 @@
 
 #include <QObject>
 
+class ConfigManager;
 class KStatusNotifierItem;
 
 class TrayManager : public QObject
@@ -16,11 +17,16 @@ public:
     void setUnreadIndicator(bool show);
     void setIndicatorEnabled(bool enabled);
     void setTooltipEnabled(bool enabled);
+    // Apply tray icon, tooltip and indicator options edited on disk
+    void followConfigChanges(const ConfigManager &config);
 
 signals:
     void showRequested();
     void hideRequested();
     void activated();
+    // Early sign the user is about to open the window: context menu opened
+    // or a scroll over the icon. SNI does not report pointer hover.
+    void intentDetected(const QString &source);
 
 private:
     void updateIcon();
@@ -0,0 +1,273 @@
+// traystub.cpp
+#include "traystub.h"
+#include "configmanager.h"
+#include "ipcmanager.h"
+#include "logger.h"
+#include "traymanager.h"
+
+#include <QApplication>
+#include <QIcon>
+
+namespace {
+
+    // The UI process may still be starting its IPC server
+    constexpr int FORWARD_RETRY_MS = 1000;
+    // UI shutdown: config sync, latency and trace files, profile flush
+    constexpr int UI_EXIT_TIMEOUT_MS = 10000;
+
+}
+
+TrayStub::TrayStub(ConfigManager &config, QObject *parent)
+: QObject(parent),
+m_config(config),
+m_tray(new TrayManager(this)),
+m_ipc(new IpcManager(this))
+{
+    m_checkTimer.setSingleShot(true);
+    connect(&m_checkTimer, &QTimer::timeout, this, &TrayStub::startCheck);
+}
+
+TrayStub::~TrayStub()
+{
+    // ~QProcess kills a process that is still running
+    if (isUiRunning() && !m_ui->waitForFinished(UI_EXIT_TIMEOUT_MS))
+        Logger::log(Logger::Level::Warning, "TrayStub: UI process did not exit in time, killing it");
+}
+
+bool TrayStub::initialize()
+{
+    Logger::log("TrayStub: Starting resident tray process");
+
+    QString trayIconToUse = m_config.customTrayIcon();
+    if (trayIconToUse.isEmpty())
+        trayIconToUse = "whatsit";
+
+    QIcon icon = QIcon::fromTheme(trayIconToUse);
+    if (icon.isNull())
+        icon = QIcon(trayIconToUse);
+    if (icon.isNull() && trayIconToUse != "whatsit") {
+        trayIconToUse = "whatsit";
+        icon = QIcon::fromTheme(trayIconToUse);
+    }
+    if (icon.isNull()) {
+        Logger::log("TrayStub: No tray icon could be found.");
+        return false;
+    }
+
+    m_tray->initialize();
+    m_tray->setIndicatorEnabled(m_config.showTrayIndicator());
+    m_tray->setTooltipEnabled(m_config.showTrayTooltip());
+    m_tray->setIcon(trayIconToUse);
+    m_tray->followConfigChanges(m_config);
+
+    connect(m_tray, &TrayManager::showRequested, this, [this] { showUi(); });
+    connect(m_tray, &TrayManager::hideRequested, this, &TrayStub::hideUi);
+    connect(m_tray, &TrayManager::activated, this, &TrayStub::toggleUi);
+    connect(m_tray, &TrayManager::intentDetected, this, &TrayStub::prewarmUi);
+
+    connect(m_ipc, &IpcManager::raiseRequested, this, [this] { showUi(); });
+    connect(m_ipc, &IpcManager::hideRequested, this, &TrayStub::hideUi);
+    connect(m_ipc, &IpcManager::openUrlRequested, this, &TrayStub::showUi);
+    connect(m_ipc, &IpcManager::unreadReported, m_tray, &TrayManager::setUnreadIndicator);
+    connect(m_ipc, &IpcManager::visibilityReported, this, &TrayStub::handleVisibility);
+    connect(m_ipc, &IpcManager::checkFinished, this, &TrayStub::handleCheckFinished);
+    connect(m_ipc, &IpcManager::quitRequested, this, &TrayStub::handleQuitRequested);
+    connect(m_ipc, &IpcManager::restartRequested, this, &TrayStub::handleRestartRequested);
+    m_ipc->start(IpcManager::MainServer);
+
+    // A new check interval takes effect now, not after the next check
+    connect(&m_config, &ConfigManager::intChanged, this, [this](ConfigSchema::IntKey key) {
+        if (key != ConfigSchema::IntKey::BackgroundCheckInterval
+            && key != ConfigSchema::IntKey::BackgroundCheckMaxInterval)
+            return;
+        if (!m_uiVisible)
+            scheduleNextCheck(true);
+    });
+
+    return true;
+}
+
+void TrayStub::start(const QString &command, const QUrl &url)
+{
+    bool showWindow = !m_config.startMinimizedInTray();
+    if (command == "show" || url.isValid())
+        showWindow = true;
+    else if (command == "hide")
+        showWindow = false;
+
+    if (showWindow)
+        showUi(url);
+    else
+        scheduleNextCheck(true);
+}
+
+void TrayStub::showUi(const QUrl &url)
+{
+    m_tray->setUnreadIndicator(false);
+
+    if (!isUiRunning()) {
+        QStringList arguments { "show" };
+        if (url.isValid())
+            arguments << url.toString();
+        launchUi(arguments);
+        return;
+    }
+
+    QString message = "raise";
+    if (url.isValid())
+        message += "|" + url.toString();
+    forwardToUi(message);
+}
+
+void TrayStub::hideUi()
+{
+    if (isUiRunning())
+        forwardToUi("hide");
+}
+
+void TrayStub::toggleUi()
+{
+    if (isUiRunning())
+        forwardToUi("toggle");
+    else
+        showUi();
+}
+
+void TrayStub::startCheck()
+{
+    if (m_uiVisible)
+        return;
+
+    Logger::log("TrayStub: Background check due");
+    if (isUiRunning())
+        forwardToUi("check");
+    else
+        launchUi({ "check" });
+}
+
+void TrayStub::prewarmUi(const QString &source)
+{
+    if (m_uiVisible || !m_config.prewarmOnIntent())
+        return;
+
+    Logger::log("TrayStub: Show intent (" + source + "), prewarming UI process");
+    if (isUiRunning())
+        forwardToUi("prewarm");
+    else
+        launchUi({ "prewarm" });
+}
+
+void TrayStub::handleVisibility(bool visible)
+{
+    m_uiVisible = visible;
+    if (visible) {
+        m_checkTimer.stop();
+        m_tray->setUnreadIndicator(false);
+    } else {
+        scheduleNextCheck(true);
+    }
+}
+
+void TrayStub::handleCheckFinished(bool foundActivity)
+{
+    m_scheduler.recordResult(foundActivity);
+    if (!m_uiVisible)
+        scheduleNextCheck(false);
+}
+
+void TrayStub::handleUiFinished(int exitCode, QProcess::ExitStatus status)
+{
+    Logger::log(QString("TrayStub: UI process exited (%1, code %2)")
+            .arg(status == QProcess::NormalExit ? "normal" : "crashed")
+            .arg(exitCode));
+
+    m_ui->deleteLater();
+    m_ui = nullptr;
+    m_uiVisible = false;
+
+    if (m_quitting) {
+        qApp->quit();
+        return;
+    }
+    if (m_restarting) {
+        m_restarting = false;
+        showUi();
+        return;
+    }
+
+    if (!m_checkTimer.isActive())
+        scheduleNextCheck(false);
+}
+
+void TrayStub::handleQuitRequested()
+{
+    Logger::log("TrayStub: Quit requested by UI process.");
+    m_quitting = true;
+    m_checkTimer.stop();
+
+    if (!isUiRunning()) {
+        qApp->quit();
+        return;
+    }
+    // A UI stuck in shutdown must not keep the stub around forever
+    QTimer::singleShot(UI_EXIT_TIMEOUT_MS, qApp, &QCoreApplication::quit);
+}
+
+void TrayStub::handleRestartRequested()
+{
+    Logger::log("TrayStub: Restart requested by UI process.");
+    if (isUiRunning())
+        m_restarting = true;
+    else
+        showUi();
+}
+
+bool TrayStub::isUiRunning() const
+{
+    return m_ui && m_ui->state() != QProcess::NotRunning;
+}
+
+void TrayStub::launchUi(const QStringList &arguments)
+{
+    if (m_quitting)
+        return;
+
+    const QString program = QCoreApplication::applicationDirPath() + "/whatsit";
+    Logger::log("TrayStub: Launching UI process: whatsit --managed " + arguments.join(' '));
+
+    m_ui = new QProcess(this);
+    m_ui->setProcessChannelMode(QProcess::ForwardedChannels);
+    connect(m_ui, &QProcess::finished, this, &TrayStub::handleUiFinished);
+    m_ui->start(program, QStringList { "--managed" } + arguments);
+}
+
+void TrayStub::forwardToUi(const QString &message, bool retry)
+{
+    if (IpcManager::sendMessage(IpcManager::UiServer, message))
+        return;
+
+    if (!retry || !isUiRunning()) {
+        Logger::log("TrayStub: Could not reach UI process for '" + message.section('|', 0, 0) + "'");
+        return;
+    }
+
+    QTimer::singleShot(FORWARD_RETRY_MS, this, [this, message] {
+        forwardToUi(message, false);
+    });
+}
+
+void TrayStub::scheduleNextCheck(bool restart)
+{
+    int floor = m_config.backgroundCheckInterval();
+    if (floor <= 0) {
+        m_checkTimer.stop();
+        return;
+    }
+
+    m_scheduler.setBounds(floor, m_config.backgroundCheckMaxInterval());
+    if (restart)
+        m_scheduler.reset();
+
+    Logger::log("TrayStub: Background check scheduler: " + m_scheduler.describe());
+    m_checkTimer.start(m_scheduler.intervalMinutes() * 60 * 1000);
+}
@@ -0,0 +1,62 @@
+// traystub.h
+#pragma once
+
+#include "checkscheduler.h"
+
+#include <QObject>
+#include <QProcess>
+#include <QTimer>
+#include <QUrl>
+
+class ConfigManager;
+class IpcManager;
+class TrayManager;
+
+// Resident half of split-process mode. Owns the tray icon, the single-instance
+// IPC server and the background check schedule, and starts the WebEngine UI
+// process ("whatsit --managed") only when the window is shown or a check is due.
+// The UI process exits by itself after Advanced/StubIdleExit minutes hidden.
+class TrayStub : public QObject
+{
+    Q_OBJECT
+public:
+    explicit TrayStub(ConfigManager &config, QObject *parent = nullptr);
+    // Gives a running UI process time to finish its own shutdown
+    ~TrayStub() override;
+
+    // false if no tray icon could be found
+    bool initialize();
+    // Command line of the stub itself: "show", "hide" or nothing
+    void start(const QString &command, const QUrl &url);
+
+private slots:
+    void showUi(const QUrl &url = QUrl());
+    void hideUi();
+    void toggleUi();
+    void startCheck();
+    void prewarmUi(const QString &source);
+    void handleVisibility(bool visible);
+    void handleCheckFinished(bool foundActivity);
+    void handleUiFinished(int exitCode, QProcess::ExitStatus status);
+    // The UI asked to quit the app: quit once it has exited itself
+    void handleQuitRequested();
+    // The UI is restarting itself: start a new one once it has exited
+    void handleRestartRequested();
+
+private:
+    bool isUiRunning() const;
+    void launchUi(const QStringList &arguments);
+    // Retries once if the UI process has not started listening yet
+    void forwardToUi(const QString &message, bool retry = true);
+    void scheduleNextCheck(bool restart);
+
+    ConfigManager &m_config;
+    TrayManager *m_tray;
+    IpcManager *m_ipc;
+    QProcess *m_ui = nullptr;
+    QTimer m_checkTimer;
+    CheckScheduler m_scheduler;
+    bool m_uiVisible = false;
+    bool m_quitting = false;
+    bool m_restarting = false;
+};
@@ -0,0 +1,148 @@
+// usagepredictor.cpp
+#include "usagepredictor.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+    constexpr quint32 FILE_MAGIC = 0x57555031; // "WUP1"
+    constexpr double HALF_LIFE_DAYS = 14.0;
+    constexpr qint64 DAY_MS = 24LL * 60 * 60 * 1000;
+
+    // A slot is typical with about two recent shows on that weekday, or a
+    // daily habit seen on most other days
+    constexpr double TYPICAL_SCORE = 2.0;
+    constexpr double OTHER_DAYS_WEIGHT = 0.25;
+    // Shows jitter by a few minutes; give the neighbouring slots some credit
+    constexpr float NEIGHBOUR_WEIGHT = 0.5f;
+
+}
+
+void UsagePredictor::load(const QString &path)
+{
+    m_path = path;
+    m_counts.fill(0.0f);
+    m_decayedAtMs = QDateTime::currentMSecsSinceEpoch();
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    QDataStream in(&file);
+    in.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    quint32 magic = 0;
+    qint64 decayedAt = 0;
+    in >> magic >> decayedAt;
+    if (magic != FILE_MAGIC)
+        return;
+
+    std::array<float, 7 * SLOTS_PER_DAY> counts {};
+    for (float &count : counts)
+        in >> count;
+    if (in.status() != QDataStream::Ok)
+        return;
+
+    m_counts = counts;
+    m_decayedAtMs = decayedAt;
+}
+
+bool UsagePredictor::save() const
+{
+    if (m_path.isEmpty())
+        return false;
+
+    QSaveFile file(m_path);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream out(&file);
+    out.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    out << FILE_MAGIC << m_decayedAtMs;
+    for (float count : m_counts)
+        out << count;
+
+    return file.commit();
+}
+
+void UsagePredictor::recordShow(const QDateTime &when)
+{
+    const qint64 nowMs = when.toMSecsSinceEpoch();
+    const float factor = static_cast<float>(decayFactor(nowMs));
+    for (float &count : m_counts)
+        count *= factor;
+    m_decayedAtMs = nowMs;
+
+    const int index = indexOf(when);
+    const int size = static_cast<int>(m_counts.size());
+    m_counts[index] += 1.0f;
+    m_counts[(index + size - 1) % size] += NEIGHBOUR_WEIGHT;
+    m_counts[(index + 1) % size] += NEIGHBOUR_WEIGHT;
+}
+
+QDateTime UsagePredictor::nextLikelyShow(const QDateTime &from) const
+{
+    // Scores are stored as of m_decayedAtMs; age the threshold instead of the data
+    const double factor = decayFactor(from.toMSecsSinceEpoch());
+    if (factor <= 0.0)
+        return QDateTime();
+    const double threshold = TYPICAL_SCORE / factor;
+
+    // Round up to the next slot boundary
+    QDateTime slot = from;
+    slot.setTime(QTime(from.time().hour(), from.time().minute() / SLOT_MINUTES * SLOT_MINUTES));
+    if (slot < from)
+        slot = slot.addSecs(SLOT_MINUTES * 60);
+
+    for (int i = 0; i < SLOTS_PER_DAY; ++i) {
+        if (score(indexOf(slot)) >= threshold)
+            return slot;
+        slot = slot.addSecs(SLOT_MINUTES * 60);
+    }
+    return QDateTime();
+}
+
+QString UsagePredictor::describe() const
+{
+    const double factor = decayFactor(QDateTime::currentMSecsSinceEpoch());
+    int typical = 0;
+    double total = 0.0;
+    for (int i = 0; i < static_cast<int>(m_counts.size()); ++i) {
+        total += m_counts[i];
+        if (factor > 0.0 && score(i) >= TYPICAL_SCORE / factor)
+            typical++;
+    }
+    return QString("%1 typical slots of %2, %3 weighted shows")
+        .arg(typical)
+        .arg(m_counts.size())
+        .arg(total * factor, 0, 'f', 1);
+}
+
+int UsagePredictor::indexOf(const QDateTime &when)
+{
+    const int day = when.date().dayOfWeek() - 1; // Monday = 0
+    const int slot = (when.time().hour() * 60 + when.time().minute()) / SLOT_MINUTES;
+    return day * SLOTS_PER_DAY + slot;
+}
+
+double UsagePredictor::decayFactor(qint64 nowMs) const
+{
+    const double days = std::max<qint64>(0, nowMs - m_decayedAtMs) / double(DAY_MS);
+    return std::pow(0.5, days / HALF_LIFE_DAYS);
+}
+
+double UsagePredictor::score(int index) const
+{
+    const int slot = index % SLOTS_PER_DAY;
+    double others = 0.0;
+    for (int day = 0; day < 7; ++day) {
+        const int i = day * SLOTS_PER_DAY + slot;
+        if (i != index)
+            others += m_counts[i];
+    }
+    return m_counts[index] + OTHER_DAYS_WEIGHT * others;
+}
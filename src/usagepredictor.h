@@ -0,0 +1,38 @@
+// usagepredictor.h
+#pragma once
+
+#include <QDateTime>
+#include <QString>
+#include <array>
+
+// When does the user usually open the window? Shows are counted in
+// 15 minute slots per weekday (7 x 96 floats, under 3 KB on disk). Counts
+// decay with a two week half-life, so a changed routine takes over within
+// a few weeks and stale habits fade out.
+class UsagePredictor
+{
+public:
+    static constexpr int SLOT_MINUTES = 15;
+    static constexpr int SLOTS_PER_DAY = 24 * 60 / SLOT_MINUTES;
+
+    // Missing or unreadable file: start empty, save() creates it
+    void load(const QString &path);
+    bool save() const;
+
+    void recordShow(const QDateTime &when);
+
+    // Start of the first typical slot at or after 'from', looking one day
+    // ahead. Invalid if nothing in that range is typical.
+    QDateTime nextLikelyShow(const QDateTime &from) const;
+    QString describe() const;
+
+private:
+    static int indexOf(const QDateTime &when);
+    // Decay factor from the last stored decay to nowMs
+    double decayFactor(qint64 nowMs) const;
+    double score(int index) const;
+
+    std::array<float, 7 * SLOTS_PER_DAY> m_counts {};
+    qint64 m_decayedAtMs = 0;
+    QString m_path;
+};
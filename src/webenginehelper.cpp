@@ -1,14 +1,21 @@
 // webenginehelper.cpp
 #include "webenginehelper.h"
 #include "configmanager.h"
+#include "consolefilter.h"
+#include "latencyrecorder.h"
 #include "logger.h"
+#include "renderersupervisor.h"
+#include "trace.h"
 
 #include <KNotification>
 #include <QDesktopServices>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QFileDialog>
 #include <QFileInfo>
+#include <QPointer>
 #include <QStandardPaths>
+#include <QTimer>
 #include <QWebEngineDownloadRequest>
 #include <QWebEngineNotification>
 #include <QWebEnginePage>
@@ -23,12 +30,54 @@ namespace {
                                        "AppleWebKit/537.36 (KHTML, like Gecko) "
                                        "Chrome/120.0.0.0 Safari/537.36";
 
+    // Give lazily loaded resources time to arrive before counting
+    constexpr int CACHE_STATS_DELAY_MS = 15000;
+
+    const QString CACHE_STATS_SCRIPT = QStringLiteral(R"(
+(function() {
+    var entries = performance.getEntriesByType('navigation')
+        .concat(performance.getEntriesByType('resource'));
+    var r = { hits: 0, misses: 0, unknown: 0, transferred: 0, cached: 0 };
+    entries.forEach(function(e) {
+        if (e.name.indexOf('http') !== 0)
+            return;
+        if (e.transferSize > 0) {
+            r.misses++;
+            r.transferred += e.transferSize;
+        } else if (e.decodedBodySize > 0) {
+            r.hits++;
+            r.cached += e.decodedBodySize;
+        } else {
+            r.unknown++;
+        }
+    });
+    return r;
+})();
+)");
+
+    // Media blocked during a lean background check stays broken; ask for it
+    // again. Images that failed for any reason get another try too.
+    const QString RETRY_DEFERRED_SCRIPT = QStringLiteral(R"(
+document.querySelectorAll('audio, video').forEach(function(media) {
+    if (media.error)
+        media.load();
+});
+document.querySelectorAll('img').forEach(function(img) {
+    if (img.src && img.complete && img.naturalWidth === 0) {
+        var src = img.src;
+        img.src = '';
+        img.src = src;
+    }
+});
+)");
+
     class WhatsitPage : public QWebEnginePage
     {
     public:
-        explicit WhatsitPage(QWebEngineProfile *profile, QObject *parent = nullptr)
+        explicit WhatsitPage(QWebEngineProfile *profile, ConsoleFilter *console, QObject *parent = nullptr)
         : QWebEnginePage(profile, parent),
-        m_profile(profile)
+        m_profile(profile),
+        m_console(console)
         {}
 
     protected:
@@ -37,13 +86,9 @@ namespace {
                                       int lineNumber,
                                       const QString &sourceID) override
         {
-            if (message.contains("Error with Permissions-Policy header") ||
-                message.contains("multiple-uim-roots") ||
-                message.contains("Subsequent non-fatal errors won't be logged")) {
-                return;
-            }
-            Logger::log(QString("JS Console: %1 (Line %2, Source: %3)").arg(message).arg(lineNumber).arg(sourceID));
-            QWebEnginePage::javaScriptConsoleMessage(level, message, lineNumber, sourceID);
+            // Nothing at all to do unless lines of this level are wanted
+            if (ConsoleFilter::wanted(level) && m_console->handle(level, message, lineNumber, sourceID))
+                QWebEnginePage::javaScriptConsoleMessage(level, message, lineNumber, sourceID);
         }
         bool javaScriptConfirm(const QUrl &securityOrigin, const QString &msg) override
         {
@@ -74,6 +119,7 @@ namespace {
 
     private:
         QWebEngineProfile *m_profile;
+        ConsoleFilter *m_console;
 
         class ExternalPage : public QWebEnginePage
         {
@@ -101,13 +147,22 @@ WebEngineHelper::WebEngineHelper(QWebEngineView *view,
 : QObject(parent),
 m_view(view),
 m_profile(nullptr),
-m_config(config)
+m_config(config),
+m_supervisor(new RendererSupervisor(this)),
+m_interceptor(new LeanRequestInterceptor(this)),
+m_console(new ConsoleFilter(this))
 {
+    connect(m_config, &ConfigManager::stringListChanged, this, [this](ConfigSchema::StringListKey key, const QStringList &value) {
+        if (key == ConfigSchema::StringListKey::ConsoleFilters)
+            m_console->setFilters(value);
+    });
 }
 
 void WebEngineHelper::initialize()
 {
     Logger::log("WebEngineHelper::initialize");
+    QElapsedTimer timer;
+    timer.start();
     const QString dataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
     const QString cachePath = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
 
@@ -123,6 +178,10 @@ void WebEngineHelper::initialize()
     m_profile->setPersistentCookiesPolicy(
         QWebEngineProfile::ForcePersistentCookies);
 
+    applyCachePolicy();
+    m_profile->setUrlRequestInterceptor(m_interceptor);
+    m_console->setFilters(m_config->consoleFilters());
+
     connect(m_profile, &QWebEngineProfile::downloadRequested,
         this, &WebEngineHelper::handleDownloadRequested);
 
@@ -132,12 +191,13 @@ void WebEngineHelper::initialize()
 
     // Notification Presenter
     m_profile->setNotificationPresenter([this](std::unique_ptr<QWebEngineNotification> notification) {
+        TRACE_SCOPE("notification");
         if (!m_config->systemNotifications()) {
-            Logger::log("WebEngineHelper: Notification received but System Notifications are DISABLED.");
+            WHATSIT_LOG(Info, Notify, "WebEngineHelper: Notification received but System Notifications are DISABLED.");
             return;
         }
 
-        Logger::log("WebEngineHelper: New notification received.");
+        WHATSIT_LOG(Debug, Notify, "WebEngineHelper: New notification received.");
 
         KNotification *knotify = new KNotification("whatsapp-message", KNotification::CloseOnTimeout);
         knotify->setComponentName("whatsit");
@@ -147,17 +207,17 @@ void WebEngineHelper::initialize()
         QString message = notification->message();
         if (message.isEmpty()) {
             message = "New Message";
-            Logger::log("Message was empty, using fallback.");
+            WHATSIT_LOG(Debug, Notify, "Message was empty, using fallback.");
         }
         knotify->setText(message);
         knotify->setIconName("whatsit");
 
         QImage icon = notification->icon();
         if (!icon.isNull()) {
-            Logger::log("Notify::Icon: Valid (" + QString::number(icon.width()) + "x" + QString::number(icon.height()) + ")");
+            WHATSIT_LOG(Debug, Notify, "Notify::Icon: Valid (" + QString::number(icon.width()) + "x" + QString::number(icon.height()) + ")");
             knotify->setPixmap(QPixmap::fromImage(icon));
         } else {
-            Logger::log("Notify::Icon: Null/Empty");
+            WHATSIT_LOG(Debug, Notify, "Notify::Icon: Null/Empty");
         }
 
         QWebEngineNotification *rawNotif = notification.release();
@@ -167,7 +227,7 @@ void WebEngineHelper::initialize()
         
         // Handle click: Activate window AND tell WebEngine
         QObject::connect(defaultAction, &KNotificationAction::activated, rawNotif, [this, rawNotif]() {
-            Logger::log("WebEngineHelper: Notification clicked. Requesting activation.");
+            WHATSIT_LOG(Info, Notify, "WebEngineHelper: Notification clicked. Requesting activation.");
             emit activationRequested();
             rawNotif->click();
         });
@@ -176,19 +236,63 @@ void WebEngineHelper::initialize()
         QObject::connect(rawNotif, &QWebEngineNotification::closed, knotify, &KNotification::close);
         QObject::connect(knotify, &KNotification::closed, knotify, &QObject::deleteLater);
 
-        Logger::log("WebEngineHelper: Calling notification->show() and sending KNotification event...");
+        WHATSIT_LOG(Debug, Notify, "WebEngineHelper: Calling notification->show() and sending KNotification event...");
         rawNotif->show();
         knotify->sendEvent();
-        Logger::log("WebEngineHelper: Notification displayed.");
+        WHATSIT_LOG(Info, Notify, "WebEngineHelper: Notification displayed.");
 
         emit notificationReceived();
     });
 
-    auto *page = new WhatsitPage(m_profile, m_view);
+    if (m_view)
+        createPage();
+
+    // Includes starting the browser process for the profile
+    LatencyRecorder::record("startup.webengine-init", timer.elapsed());
+}
+
+void WebEngineHelper::attachView(QWebEngineView *view)
+{
+    m_view = view;
+    if (m_profile && m_view)
+        createPage();
+}
+
+void WebEngineHelper::releaseView()
+{
+    if (!m_view)
+        return;
+
+    Logger::log("WebEngineHelper: Releasing view and page");
+    m_supervisor->attach(nullptr);
+    disconnect(m_view, nullptr, this, nullptr);
+    if (QWebEnginePage *page = m_view->page())
+        disconnect(page, nullptr, this, nullptr);
+    m_hasDeferredRequests = false;
+    m_view = nullptr;
+}
+
+bool WebEngineHelper::hasView() const
+{
+    return m_view != nullptr;
+}
+
+// Everything tied to one page. The profile, its notification presenter and
+// the request interceptor outlive it, so this can run again after releaseView().
+void WebEngineHelper::createPage()
+{
+    auto *page = new WhatsitPage(m_profile, m_console, m_view);
     m_view->setPage(page);
 
     connect(m_view, &QWebEngineView::titleChanged, this, &WebEngineHelper::handleTitleChanged);
 
+    m_supervisor->attach(page);
+
+    connect(page, &QWebEnginePage::loadFinished, this, [this](bool ok) {
+        if (ok)
+            QTimer::singleShot(CACHE_STATS_DELAY_MS, this, &WebEngineHelper::collectCacheStats);
+    });
+
     connect(page, &QWebEnginePage::permissionRequested,
             this, [this](QWebEnginePermission permission) {
 
@@ -197,9 +301,10 @@ void WebEngineHelper::initialize()
 
         const bool isWhatsapp = (host == "web.whatsapp.com") || (host.endsWith(".whatsapp.com"));
         const auto type = permission.permissionType();
+        Trace::instant("permission-requested", QString::number(static_cast<int>(type)));
 
-        Logger::log("WebEngineHelper: Permission requested");
-        Logger::log("Type: " + QString::number(static_cast<int>(type)));
+        WHATSIT_LOG(Info, Web, "WebEngineHelper: Permission requested");
+        WHATSIT_LOG(Debug, Web, "Type: " + QString::number(static_cast<int>(type)));
 
         if (!isWhatsapp) { // if not from whatsapp
             Logger::log("Not Whatsapp, denying permission");
@@ -211,9 +316,9 @@ void WebEngineHelper::initialize()
             case QWebEnginePermission::PermissionType::Notifications:
                 if (m_config->systemNotifications()) {
                     Logger::log("WebEngineHelper: Notification Permission Requested via QWebEnginePermission");
-                    Logger::log("Granting permission...");
+                    WHATSIT_LOG(Debug, Web, "Granting permission...");
                     permission.grant();
-                    Logger::log("Permission granted.");
+                    WHATSIT_LOG(Debug, Web, "Permission granted.");
                 } else {
                     Logger::log("WebEngineHelper: Notification Permission disable in config: Deny");
                     permission.deny(); // why didn't you add this before? wait can we even deny notification permission?
@@ -234,7 +339,7 @@ void WebEngineHelper::initialize()
                 break;
 
             default: // deny any other permission
-                Logger::log("Origin: " + permission.origin().toString());
+                WHATSIT_LOG(Debug, Web, "Origin: " + permission.origin().toString());
                 Logger::log("WebEngineHelper: Unknown Permission Requested");
                 permission.deny();
                 break;
@@ -246,11 +351,19 @@ void WebEngineHelper::initialize()
 
 void WebEngineHelper::handleTitleChanged(const QString &title)
 {
+    TRACE_SCOPE("title-changed");
     // WhatsApp unread titles usually look like "(1) WhatsApp" or similar
-    bool hasUnread = title.contains('(') && title.contains(')');
-    // comment by: devlinman
-    // int number_of_notifications =
-    emit unreadChanged(hasUnread);
+    int unreadCount = 0;
+    const int open = title.indexOf('(');
+    const int close = title.indexOf(')', open + 1);
+    if (open >= 0 && close > open) {
+        bool ok = false;
+        unreadCount = title.mid(open + 1, close - open - 1).toInt(&ok);
+        if (!ok || unreadCount <= 0)
+            unreadCount = 1; // unread, count unknown
+    }
+    WHATSIT_LOG(Debug, Web, QString("WebEngineHelper: Title changed (unread: %1)").arg(unreadCount));
+    emit unreadChanged(unreadCount);
 }
 
 void WebEngineHelper::setAudioMuted(bool muted)
@@ -261,10 +374,122 @@ void WebEngineHelper::setAudioMuted(bool muted)
     }
 }
 
+void WebEngineHelper::clearHttpCache()
+{
+    if (!m_profile)
+        return;
+    Logger::log("WebEngineHelper: Clearing HTTP cache");
+    m_profile->clearHttpCache();
+}
+
+void WebEngineHelper::applyCachePolicy()
+{
+    if (!m_profile)
+        return;
+
+    const QString type = m_config->httpCacheType();
+    if (type == "memory") {
+        m_profile->setHttpCacheType(QWebEngineProfile::MemoryHttpCache);
+    } else if (type == "none") {
+        m_profile->setHttpCacheType(QWebEngineProfile::NoCache);
+    } else {
+        m_profile->setHttpCacheType(QWebEngineProfile::DiskHttpCache);
+    }
+    // 0 lets Chromium pick the size
+    m_profile->setHttpCacheMaximumSize(m_config->httpCacheMaximumSize() * 1024 * 1024);
+
+    Logger::log(QString("WebEngineHelper: HTTP cache: %1, max %2 MB")
+                    .arg(type)
+                    .arg(m_config->httpCacheMaximumSize()));
+}
+
+HttpCacheStats WebEngineHelper::cacheStats() const
+{
+    return m_cacheStats;
+}
+
+void WebEngineHelper::collectCacheStats()
+{
+    QWebEnginePage *page = m_view ? m_view->page() : nullptr;
+    if (!page || page->lifecycleState() != QWebEnginePage::LifecycleState::Active)
+        return;
+    if (!page->url().scheme().startsWith("http"))
+        return;
+
+    QPointer<WebEngineHelper> self(this);
+    page->runJavaScript(CACHE_STATS_SCRIPT, [self](const QVariant &result) {
+        if (!self)
+            return;
+        const QVariantMap r = result.toMap();
+        if (r.isEmpty())
+            return;
+
+        const qint64 hits = r.value("hits").toLongLong();
+        const qint64 misses = r.value("misses").toLongLong();
+
+        HttpCacheStats &stats = self->m_cacheStats;
+        stats.loads++;
+        stats.hits += hits;
+        stats.misses += misses;
+        stats.unknown += r.value("unknown").toLongLong();
+        stats.transferredBytes += r.value("transferred").toLongLong();
+        stats.cachedBytes += r.value("cached").toLongLong();
+
+        const qint64 known = stats.hits + stats.misses;
+        Logger::log(QString("HTTP cache: this load %1 hits / %2 misses; session hit ratio %3% "
+                            "(%4 KB from cache, %5 KB from network)")
+                        .arg(hits)
+                        .arg(misses)
+                        .arg(known > 0 ? stats.hits * 100 / known : 0)
+                        .arg(stats.cachedBytes / 1024)
+                        .arg(stats.transferredBytes / 1024));
+    });
+}
+
+void WebEngineHelper::setLeanMode(bool enabled)
+{
+    if (m_interceptor->isEnabled() == enabled)
+        return;
+
+    Logger::log(QString("WebEngineHelper: Lean mode %1").arg(enabled ? "ON" : "OFF"));
+    m_interceptor->setEnabled(enabled);
+
+    if (m_view && m_view->page())
+        m_view->page()->settings()->setAttribute(QWebEngineSettings::AutoLoadImages, !enabled);
+}
+
+LeanRequestInterceptor::Counts WebEngineHelper::takeLeanCounts()
+{
+    const LeanRequestInterceptor::Counts counts = m_interceptor->takeCounts();
+    if (counts.total() > 0)
+        m_hasDeferredRequests = true;
+    return counts;
+}
+
+void WebEngineHelper::retryDeferredRequests()
+{
+    // Pick up anything blocked after the last takeLeanCounts() too
+    if (m_interceptor->takeCounts().total() > 0)
+        m_hasDeferredRequests = true;
+
+    if (!m_hasDeferredRequests || !m_view || !m_view->page())
+        return;
+
+    m_hasDeferredRequests = false;
+    Logger::log("WebEngineHelper: Re-requesting media blocked by lean mode");
+    m_view->page()->runJavaScript(RETRY_DEFERRED_SCRIPT);
+}
+
+void WebEngineHelper::restartRenderer()
+{
+    m_supervisor->recycle("memory");
+}
+
 void WebEngineHelper::handleDownloadRequested(QWebEngineDownloadRequest *download)
 {
     // // Debug: log download file name. disabled for privacy.
     // Logger::log("Download requested: " + download->suggestedFileName());
+    TRACE_SCOPE("download-requested");
     Logger::log("Download requested");
     QString baseDir = m_config->downloadPath();
     if (baseDir.isEmpty()) {
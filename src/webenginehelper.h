@@ -1,12 +1,27 @@
 // webenginehelper.h
 #pragma once
 
+#include "leaninterceptor.h"
+
 #include <QObject>
 
 class ConfigManager;
+class ConsoleFilter;
 class QWebEngineView;
 class QWebEngineProfile;
 class QWebEngineDownloadRequest;
+class RendererSupervisor;
+
+// Cache effectiveness, from the page's Resource Timing entries.
+// A resource with transferSize 0 but a body was served from cache.
+struct HttpCacheStats {
+    int loads = 0;
+    qint64 hits = 0;
+    qint64 misses = 0;
+    qint64 unknown = 0; // cross-origin without Timing-Allow-Origin
+    qint64 transferredBytes = 0;
+    qint64 cachedBytes = 0;
+};
 
 class WebEngineHelper : public QObject
 {
@@ -17,20 +32,46 @@ public:
                              QObject *parent = nullptr);
 
     void initialize();
+    // Deep sleep: hand a new view a fresh page, or let go of the current one
+    // before it is destroyed. The profile stays loaded in between.
+    void attachView(QWebEngineView *view);
+    void releaseView();
+    bool hasView() const;
     QWebEngineProfile *profile() const;
     void setAudioMuted(bool muted);
+    void clearHttpCache();
+    void applyCachePolicy();
+    HttpCacheStats cacheStats() const;
+
+    // Lean mode: defer images, block media and favicons while a hidden background check runs
+    void setLeanMode(bool enabled);
+    // Blocked requests since the last call
+    LeanRequestInterceptor::Counts takeLeanCounts();
+    // Re-request media that lean mode left broken (call once the window is shown)
+    void retryDeferredRequests();
+    // Kill the renderer process and reload the page in a fresh one
+    void restartRenderer();
 
 signals:
     void notificationReceived();
-    void unreadChanged(bool hasUnread);
+    // From the title; 0 = nothing unread
+    void unreadChanged(int unreadCount);
     void activationRequested();
 
 private slots:
     void handleDownloadRequested(QWebEngineDownloadRequest *download);
     void handleTitleChanged(const QString &title);
+    void collectCacheStats();
 
 private:
+    void createPage();
+
     QWebEngineView *m_view;
     QWebEngineProfile *m_profile;
     ConfigManager *m_config;
+    RendererSupervisor *m_supervisor;
+    HttpCacheStats m_cacheStats;
+    LeanRequestInterceptor *m_interceptor;
+    ConsoleFilter *m_console;
+    bool m_hasDeferredRequests = false;
 };